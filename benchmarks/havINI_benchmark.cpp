@@ -0,0 +1,508 @@
+// Benchmarks of parsing, lookups, inserts, array access and writing on synthetic INI files.
+// Throughput is reported as bytes_per_second or items_per_second, "allocs" is the number of allocations per iteration.
+
+#include "havINI.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::atomic<std::size_t> gAllocationCount{ 0 };
+
+    // Returns nullptr if the memory is exhausted, alignments up to the one of malloc are served by malloc
+    void* Allocate(std::size_t size, std::size_t alignment) noexcept
+    {
+        gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        size = (size == 0) ? 1 : size;
+
+        if (alignment <= alignof(std::max_align_t))
+        {
+            return std::malloc(size);
+        }
+
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc needs a size which is a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    void* AllocateOrThrow(std::size_t size, std::size_t alignment)
+    {
+        if (void* memory = Allocate(size, alignment))
+        {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void Free(void* memory, std::size_t alignment) noexcept
+    {
+#ifdef _WIN32
+        if (alignment > alignof(std::max_align_t))
+        {
+            _aligned_free(memory);
+
+            return;
+        }
+#else
+        static_cast<void>(alignment);
+#endif
+
+        std::free(memory);
+    }
+}
+
+// Every allocation of the program is counted, so the benchmarks only count the allocations between the start and the end of their loop.
+// All forms are replaced, so every delete frees the memory of the matching new.
+void* operator new(std::size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete[](void* memory) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete(void* memory, std::size_t) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete[](void* memory, std::size_t) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Free(memory, alignof(std::max_align_t)); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { Free(memory, static_cast<std::size_t>(alignment)); }
+
+namespace havINIBenchmark {
+
+    constexpr std::size_t lookupKeyCount = 1024; // Power of two, the lookups cycle through the keys
+    constexpr std::size_t insertKeyCount = 1000;
+
+    struct havINIBenchmarkFile
+    {
+        std::string name;
+        std::filesystem::path path;
+        std::size_t size;
+    };
+
+    std::filesystem::path gDirectory;
+    std::vector<havINIBenchmarkFile> gFiles;
+    bool gHasFailed = false;
+
+    // 5000 sections with 10 key value pairs each
+    std::string GenerateManySections()
+    {
+        std::string contents;
+
+        for (int section = 0; section < 5000; ++section)
+        {
+            contents += "[section_" + std::to_string(section) + "]\n";
+
+            for (int key = 0; key < 10; ++key)
+            {
+                contents += "key_" + std::to_string(key) + " = value_" + std::to_string(section) + "_" + std::to_string(key) + "\n";
+            }
+
+            contents += "\n";
+        }
+
+        return contents;
+    }
+
+    // A single section with 50000 key value pairs
+    std::string GenerateWideSection()
+    {
+        std::string contents = "[wide]\n";
+
+        for (int key = 0; key < 50000; ++key)
+        {
+            contents += "key_" + std::to_string(key) + " = value_" + std::to_string(key) + "\n";
+        }
+
+        return contents;
+    }
+
+    // 20 arrays with 5000 entries each
+    std::string GenerateLargeArrays()
+    {
+        std::string contents = "[arrays]\n";
+
+        for (int array = 0; array < 20; ++array)
+        {
+            for (int entry = 0; entry < 5000; ++entry)
+            {
+                contents += "array_" + std::to_string(array) + "[] = entry_" + std::to_string(entry) + "\n";
+            }
+        }
+
+        return contents;
+    }
+
+    // Every key value pair has a comment line and an inline comment
+    std::string GenerateCommentHeavy()
+    {
+        std::string contents = "; Generated file with many comments\n";
+
+        for (int section = 0; section < 1000; ++section)
+        {
+            contents += "[section_" + std::to_string(section) + "] ; Section comment\n";
+
+            for (int key = 0; key < 10; ++key)
+            {
+                contents += "; Comment of key " + std::to_string(key) + " which explains what it does\n";
+                contents += "# Another comment line\n";
+                contents += "key_" + std::to_string(key) + " = value_" + std::to_string(key) + " ; Inline comment\n";
+            }
+
+            contents += "\n";
+        }
+
+        return contents;
+    }
+
+    // Values with unicode escape sequences, which have to be decoded
+    std::string GenerateEscapeHeavy()
+    {
+        std::string contents;
+
+        for (int section = 0; section < 1000; ++section)
+        {
+            contents += "[section_\\x00e9_" + std::to_string(section) + "]\n";
+
+            for (int key = 0; key < 10; ++key)
+            {
+                contents += "key_" + std::to_string(key) + " = caf\\x00e9 na\\x00efve \\x00fcber \\x20ac" + std::to_string(key) + "\n";
+            }
+        }
+
+        return contents;
+    }
+
+    // The BOM notices of UTF-16 files are dropped, errors make the benchmark fail
+    void SetDiagnosticSink(havINI::havINIStream& stream, std::string& errorMessage)
+    {
+        stream.SetDiagnosticSink([&errorMessage](const havINI::havINIDiagnostic& diagnostic)
+        {
+            if (diagnostic.type == havINI::havINIDiagnosticType::Error)
+            {
+                errorMessage = diagnostic.message;
+            }
+        });
+    }
+
+    void Fail(benchmark::State& state, const std::string& errorMessage)
+    {
+        state.SkipWithError(errorMessage.c_str());
+        gHasFailed = true;
+    }
+
+    void SetAllocationCounter(benchmark::State& state, std::size_t allocationStart)
+    {
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(gAllocationCount.load() - allocationStart), benchmark::Counter::kAvgIterations);
+    }
+
+    const havINIBenchmarkFile& GetFile(const std::string& name)
+    {
+        for (const havINIBenchmarkFile& file : gFiles)
+        {
+            if (file.name == name)
+            {
+                return file;
+            }
+        }
+
+        throw std::out_of_range("Unknown benchmark file!");
+    }
+
+    // Parses a file outside of the measured loop
+    bool ParseFile(benchmark::State& state, havINI::havINIStream& stream, const std::string& name)
+    {
+        std::string errorMessage;
+
+        SetDiagnosticSink(stream, errorMessage);
+
+        if (stream.ParseFile(GetFile(name).path.string()) == false || errorMessage.empty() == false)
+        {
+            Fail(state, "Unable to parse " + name + ": " + errorMessage);
+
+            return false;
+        }
+
+        stream.SetDiagnosticSink(nullptr);
+
+        return true;
+    }
+
+    void AddFile(const std::string& name, const std::string& contents)
+    {
+        havINIBenchmarkFile file{ name, gDirectory / (name + ".ini"), contents.size() };
+
+        std::ofstream fileStream(file.path, std::ios::binary);
+        fileStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+        gFiles.push_back(std::move(file));
+    }
+
+    void WriteFiles()
+    {
+        gDirectory = std::filesystem::temp_directory_path() / "havINI_benchmark";
+        std::filesystem::create_directories(gDirectory);
+
+        AddFile("ManySections", GenerateManySections());
+        AddFile("WideSection", GenerateWideSection());
+        AddFile("LargeArrays", GenerateLargeArrays());
+        AddFile("CommentHeavy", GenerateCommentHeavy());
+        AddFile("EscapeHeavy", GenerateEscapeHeavy());
+
+        // The UTF-16 files have the same contents as ManySections
+        havINI::havINIStream stream;
+        stream.ParseString(GenerateManySections());
+
+        AddFile("ManySections_UTF16LE", stream.WriteString(false, havINI::havINIBOMType::UTF16LE));
+        AddFile("ManySections_UTF16BE", stream.WriteString(false, havINI::havINIBOMType::UTF16BE));
+    }
+
+    void BM_ParseFile(benchmark::State& state, const havINIBenchmarkFile& file)
+    {
+        std::string errorMessage;
+        std::string fileName = file.path.string();
+        std::size_t allocationStart = gAllocationCount.load();
+
+        for (auto _ : state)
+        {
+            havINI::havINIStream stream;
+            SetDiagnosticSink(stream, errorMessage);
+
+            if (stream.ParseFile(fileName) == false || errorMessage.empty() == false)
+            {
+                Fail(state, "Unable to parse " + file.name + ": " + errorMessage);
+
+                break;
+            }
+
+            benchmark::DoNotOptimize(stream);
+        }
+
+        SetAllocationCounter(state, allocationStart);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * file.size));
+    }
+
+    // Every eighth section with a key which exists or not
+    std::vector<std::pair<std::string, std::string>> GetLookupKeys(bool isHit)
+    {
+        std::vector<std::pair<std::string, std::string>> keys;
+
+        for (std::size_t index = 0; index < lookupKeyCount; ++index)
+        {
+            std::string sectionName = "section_" + std::to_string(index * 8 % 5000);
+            std::string keyName = ((isHit == true) ? "key_" : "missing_") + std::to_string(index % 10);
+
+            keys.emplace_back(std::move(sectionName), std::move(keyName));
+        }
+
+        return keys;
+    }
+
+    void BM_GetValue(benchmark::State& state, bool isHit)
+    {
+        havINI::havINIStream stream;
+
+        if (ParseFile(state, stream, "ManySections") == false)
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::string>> keys = GetLookupKeys(isHit);
+        std::string defaultValue = "default";
+        std::size_t index = 0;
+        std::size_t allocationStart = gAllocationCount.load();
+
+        for (auto _ : state)
+        {
+            const auto& key = keys[index++ & (lookupKeyCount - 1)];
+
+            benchmark::DoNotOptimize(stream.GetValue(key.first, key.second, defaultValue));
+        }
+
+        SetAllocationCounter(state, allocationStart);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_HasKey(benchmark::State& state, bool isHit)
+    {
+        havINI::havINIStream stream;
+
+        if (ParseFile(state, stream, "ManySections") == false)
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::string>> keys = GetLookupKeys(isHit);
+        std::size_t index = 0;
+        std::size_t allocationStart = gAllocationCount.load();
+
+        for (auto _ : state)
+        {
+            const auto& key = keys[index++ & (lookupKeyCount - 1)];
+
+            benchmark::DoNotOptimize(stream.HasKey(key.first, key.second));
+        }
+
+        SetAllocationCounter(state, allocationStart);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Inserts the keys of 10 sections into an empty stream
+    void BM_SetValueInsert(benchmark::State& state)
+    {
+        std::vector<std::pair<std::string, std::string>> keys;
+        std::string value = "value";
+
+        for (std::size_t index = 0; index < insertKeyCount; ++index)
+        {
+            keys.emplace_back("section_" + std::to_string(index % 10), "key_" + std::to_string(index));
+        }
+
+        std::size_t allocationStart = gAllocationCount.load();
+
+        for (auto _ : state)
+        {
+            havINI::havINIStream stream;
+
+            for (const auto& key : keys)
+            {
+                stream.SetValue(key.first, key.second, value, false);
+            }
+
+            benchmark::DoNotOptimize(stream);
+        }
+
+        SetAllocationCounter(state, allocationStart);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * insertKeyCount));
+    }
+
+    // Looks up the section and the array and reads an entry, like mIniParser["arrays"]["array_0"][index]
+    void BM_ArrayAccess(benchmark::State& state)
+    {
+        havINI::havINIStream stream;
+
+        if (ParseFile(state, stream, "LargeArrays") == false)
+        {
+            return;
+        }
+
+        int index = 0;
+        std::size_t allocationStart = gAllocationCount.load();
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(stream["arrays"]["array_7"][index].GetValue());
+
+            index = (index + 1) % 5000;
+        }
+
+        SetAllocationCounter(state, allocationStart);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_WriteFile(benchmark::State& state, havINI::havINIBOMType bomType)
+    {
+        havINI::havINIStream stream;
+
+        if (ParseFile(state, stream, "ManySections") == false)
+        {
+            return;
+        }
+
+        std::string fileName = (gDirectory / "Written.ini").string();
+        std::string errorMessage;
+        std::size_t allocationStart = gAllocationCount.load();
+
+        SetDiagnosticSink(stream, errorMessage);
+
+        for (auto _ : state)
+        {
+            if (stream.WriteFile(fileName, false, bomType) == false)
+            {
+                Fail(state, "Unable to write " + fileName + ": " + errorMessage);
+
+                break;
+            }
+        }
+
+        SetAllocationCounter(state, allocationStart);
+
+        std::error_code errorCode;
+        std::uintmax_t fileSize = std::filesystem::file_size(fileName, errorCode);
+
+        state.SetBytesProcessed((errorCode) ? 0 : static_cast<std::int64_t>(state.iterations() * fileSize));
+    }
+
+    void RegisterBenchmarks()
+    {
+        for (const havINIBenchmarkFile& file : gFiles)
+        {
+            benchmark::RegisterBenchmark(("ParseFile/" + file.name).c_str(), BM_ParseFile, file)->Unit(benchmark::kMillisecond);
+        }
+
+        benchmark::RegisterBenchmark("GetValue/Hit", BM_GetValue, true);
+        benchmark::RegisterBenchmark("GetValue/Miss", BM_GetValue, false);
+        benchmark::RegisterBenchmark("HasKey/Hit", BM_HasKey, true);
+        benchmark::RegisterBenchmark("HasKey/Miss", BM_HasKey, false);
+        benchmark::RegisterBenchmark("SetValue/Insert", BM_SetValueInsert)->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark("ArrayAccess", BM_ArrayAccess);
+
+        const std::pair<const char*, havINI::havINIBOMType> encodings[] =
+        {
+            { "UTF8", havINI::havINIBOMType::None },
+            { "UTF8BOM", havINI::havINIBOMType::UTF8 },
+            { "UTF16LE", havINI::havINIBOMType::UTF16LE },
+            { "UTF16BE", havINI::havINIBOMType::UTF16BE },
+            { "UTF32LE", havINI::havINIBOMType::UTF32LE },
+            { "UTF32BE", havINI::havINIBOMType::UTF32BE }
+        };
+
+        for (const auto& encoding : encodings)
+        {
+            benchmark::RegisterBenchmark((std::string("WriteFile/") + encoding.first).c_str(), BM_WriteFile, encoding.second)->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv) == true)
+    {
+        return 1;
+    }
+
+    havINIBenchmark::WriteFiles();
+    havINIBenchmark::RegisterBenchmarks();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::error_code errorCode;
+    std::filesystem::remove_all(havINIBenchmark::gDirectory, errorCode);
+
+    return (havINIBenchmark::gHasFailed == true) ? 1 : 0;
+}
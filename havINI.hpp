@@ -48,6 +48,14 @@ SOFTWARE.
 
 // Add -D_FILE_OFFSET_BITS=64 to CFLAGS for large file support.
 // Optionally, you can use #define HAVINI_CASE_SENSITIVE before including the header file to enforce case sensitivity for section names and keys in key/value pairs.
+// Both modes can also be used side by side with basic_havINIStream<havINICaseSensitivePolicy> and basic_havINIStream<havINICaseInsensitivePolicy>, the macro only selects the policy of havINIStream.
+// Optionally, you can use #define HAVINI_NO_HASH_INDEX before including the header file to always look up section names and keys with a linear search.
+// Optionally, you can use #define HAVINI_HASH_INDEX_THRESHOLD <number> before including the header file to change the number of sections/keys from which on the hash index is used (Default is 16).
+// All classes take an allocator for char as second template argument, havINI::pmr::havINIStream uses std::pmr::polymorphic_allocator, so a whole document can be placed into a std::pmr::monotonic_buffer_resource.
+// Optionally, you can use #define HAVINI_PARALLEL_PARSE_CHUNK_SIZE <number> before including the header file to change the minimum number of bytes per thread of a parallel parse (Default is 262144).
+// Optionally, you can use #define HAVINI_READ_CHUNK_SIZE <number> before including the header file to change the number of bytes which ParseFile and ParseFileEvents read at once (Default is 65536).
+// Optionally, you can use #define HAVINI_FILE_TIME_GRANULARITY <number> before including the header file to change the number of seconds within which ReloadFile doesn't trust an unchanged modification time (Default is 2).
+// Optionally, you can use #define HAVINI_NO_SIMD before including the header file to disable the SSE2/AVX2/NEON scanning kernels of the parser and always use the scalar fallback.
 
 #ifdef _WIN32
 #ifdef _MBCS
@@ -74,25 +82,86 @@ SOFTWARE.
 #undef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cstdio>
 #include <cstdint>
 #include <cuchar>
 #include <cstring>
+#include <filesystem>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <sstream>
 #include <locale>
 #include <optional>
+#include <variant>
 #include <memory>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <vector>
 
+#ifndef HAVINI_HASH_INDEX_THRESHOLD
+#define HAVINI_HASH_INDEX_THRESHOLD 16
+#endif
+
+#ifndef HAVINI_PARALLEL_PARSE_CHUNK_SIZE
+#define HAVINI_PARALLEL_PARSE_CHUNK_SIZE 262144
+#endif
+
+#ifndef HAVINI_READ_CHUNK_SIZE
+#define HAVINI_READ_CHUNK_SIZE 65536
+#endif
+
+#ifndef HAVINI_FILE_TIME_GRANULARITY
+#define HAVINI_FILE_TIME_GRANULARITY 2
+#endif
+
+#ifndef HAVINI_NO_SIMD
+#if defined(__AVX2__)
+#define HAVINI_SIMD_AVX2
+#define HAVINI_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVINI_SIMD_SSE2
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define HAVINI_SIMD_NEON
+#endif
+#endif
+
+#if defined(HAVINI_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(HAVINI_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(HAVINI_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(HAVINI_SIMD_SSE2) || defined(HAVINI_SIMD_NEON))
+#include <intrin.h>
+#endif
+
 static_assert(sizeof(signed char) == 1, "expected char to be 1 byte");
 static_assert(sizeof(unsigned char) == 1, "expected unsigned char to be 1 byte");
 static_assert(sizeof(signed char) == 1, "expected int8 to be 1 byte");
@@ -131,6 +200,111 @@ namespace havINI {
         Below
     };
 
+    enum class havINIParseResult : std::uint8_t
+    {
+        Completed,
+        Stopped,
+        Failed
+    };
+
+    enum class havINIChangeType : std::uint8_t
+    {
+        Added,
+        Removed,
+        Changed
+    };
+
+    // A section or key which was changed by a reload, the key name is empty if a whole section was added or removed
+    struct havINIChange
+    {
+        havINIChangeType type;
+        std::string sectionName;
+        std::string keyName;
+    };
+
+    using havINIChangeSet = std::vector<havINIChange>;
+
+    enum class havINIBindErrorType : std::uint8_t
+    {
+        Missing,
+        Invalid
+    };
+
+    // A field of a schema whose key doesn't exist or whose value can't be converted, the field keeps its default value
+    struct havINIBindError
+    {
+        havINIBindErrorType type;
+        std::string sectionName;
+        std::string keyName;
+    };
+
+    using havINIBindErrors = std::vector<havINIBindError>;
+
+    enum class havINIDiagnosticType : std::uint8_t
+    {
+        Error, // The call failed, or the parsing stopped at the line
+        Notice
+    };
+
+    enum class havINIDiagnosticCode : std::uint8_t
+    {
+        OpenFailed,
+        ReadFailed,
+        EmptyFile,
+        FileTooSmall,
+        BOMSkipped,
+        ParseError,
+        WriteFailed
+    };
+
+    // An error or notice of a stream, which is passed to the diagnostic sink instead of being printed to std::cout
+    struct havINIDiagnostic
+    {
+        havINIDiagnosticType type;
+        havINIDiagnosticCode code;
+        std::string message;
+        std::size_t line; // Line of a parse error counted from 1, zero for the other diagnostics
+    };
+
+    // Called on the thread which calls the stream
+    using havINIDiagnosticSink = std::function<void(const havINIDiagnostic& diagnostic)>;
+
+    // Measurements of the last parse call of a stream, if they're collected (see basic_havINIStream::SetCollectParseStats).
+    // Sections which lazy parsing skipped are added to the stats of that call, when they're parsed on the first access.
+    struct havINIParseStats
+    {
+        std::size_t bytesRead = 0; // Size of the file, buffer or string before it was decoded
+        std::size_t peakBufferSize = 0; // Largest input held at once, e.g. the file buffer and its UTF-8 copy or the read chunk and the partial line
+        std::size_t lineCount = 0; // Lines which were parsed without an error, unchanged sections of a reload aren't parsed
+        std::size_t sectionCount = 0; // Section headers, a section which appears twice is counted twice (Not counted by the event parsers)
+        std::size_t keyCount = 0; // Key value pairs and array entries (Not counted by the event parsers)
+        std::size_t triviaCount = 0; // Comments and empty lines which were kept (Not counted by the event parsers)
+
+        std::chrono::nanoseconds readTime{ 0 };
+        std::chrono::nanoseconds decodeTime{ 0 }; // Conversion of UTF-16 and UTF-32 to UTF-8
+        std::chrono::nanoseconds tokenizeTime{ 0 }; // Splitting the lines into names and values, includes the build time of parallel parses and the event handler
+        std::chrono::nanoseconds buildTime{ 0 }; // Adding the sections, key value pairs and array entries to the document
+    };
+
+    // Runs task(0) to task(taskCount - 1) and returns, when all of them are finished
+    using havINIParseExecutor = std::function<void(std::size_t taskCount, const std::function<void(std::size_t)>& task)>;
+
+    // Receives the lines of INI data from ParseFileEvents, ParseStringEvents and ParseBufferEvents, returning false stops the parsing.
+    // The section and key names are passed like they are stored by ParseFile, the views are only valid during the call.
+    // An inline comment or array index which doesn't exist is std::nullopt.
+    class havINIEventHandler
+    {
+        public:
+            virtual ~havINIEventHandler() = default;
+
+            virtual bool OnSection(std::string_view /* sectionName */, std::optional<std::string_view> /* inlineComment */) { return true; }
+            virtual bool OnKey(std::string_view /* sectionName */, std::string_view /* keyName */, std::string_view /* value */, bool /* isQuoted */, std::optional<std::string_view> /* inlineComment */) { return true; }
+            virtual bool OnArrayEntry(std::string_view /* sectionName */, std::string_view /* keyName */, std::optional<std::string_view> /* arrayIndex */, std::string_view /* value */, bool /* isQuoted */,
+                std::optional<std::string_view> /* inlineComment */) { return true; }
+            virtual bool OnComment(std::string_view /* sectionName */, std::string_view /* comment */) { return true; }
+            virtual bool OnEmptyLine(std::string_view /* sectionName */) { return true; }
+    };
+
     namespace havUtils
     {
         constexpr bool StartsWith(std::string_view sv, std::string_view prefix)
@@ -143,7 +317,7 @@ namespace havINI {
             return sv.size() >= suffix.size() && sv.compare(sv.size() - suffix.size(), suffix.size(), suffix) == 0;
         }
 
-        inline std::vector<std::string> Split(const std::string& value, const std::string& delimiter)
+        inline std::vector<std::string> Split(std::string_view value, std::string_view delimiter)
         {
             std::vector<std::string> result;
 
@@ -153,12 +327,12 @@ namespace havINI {
             while ((start = value.find_first_not_of(delimiter, end)) != std::string::npos)
             {
                 end = value.find(delimiter, start);
-                result.push_back(value.substr(start, end - start));
+                result.emplace_back(value.substr(start, end - start));
             }
 
             if (result.empty() == true)
             {
-                result.push_back(value);
+                result.emplace_back(value);
             }
 
             return result;
@@ -181,3400 +355,7755 @@ namespace havINI {
             return result;
         }
 
-        inline std::string ToLower(std::string value, const std::locale& loc)
+        // Section names and keys are always stored as UTF-8, so only ASCII letters are folded and multibyte sequences stay untouched
+        constexpr char ToLower(char value)
         {
-            const auto& ctype = std::use_facet<std::ctype<char>>(loc);
-            std::transform(value.begin(), value.end(), value.begin(), [&ctype](char currentChar) {
-                return ctype.tolower(currentChar);
-            });
-            return value;
+            return (value >= 'A' && value <= 'Z') ? static_cast<char>(value - 'A' + 'a') : value;
         }
-    }
 
-    class havINISection;
+        // Fast non-cryptographic hash, used to detect unchanged sections while reloading. Four independent lanes read 32 bytes at once,
+        // the result depends on the byte order and is only stored in compiled snapshots, which record the byte order of the writer.
+        // The data can be appended in pieces, the hash is the same for every split of the same bytes.
+        class havINIHasher
+        {
+            public:
+                void Append(std::string_view value)
+                {
+                    // An empty view may have no data pointer, which must not be passed to memcpy
+                    if (value.empty() == true)
+                    {
+                        return;
+                    }
 
-    class havINIData
-    {
-        public:
-            explicit havINIData(
-#ifndef HAVINI_CASE_SENSITIVE
-            const std::locale& loc,
-#endif
-            const std::string& key, const std::string& value, havINIDataType valueType, bool addQuotes = false, std::optional<std::string> inlineComment = std::nullopt, bool hasArrayIndex = false) :
-#ifndef HAVINI_CASE_SENSITIVE
-            mLocale(loc),
-#endif
-            mType(valueType), mKey(key), mValue(value), mInlineComment(inlineComment), mAddQuotes(addQuotes), mArrayIndex(0), mHasArrayIndex(hasArrayIndex)
-            {
-            }
+                    mSize += value.size();
 
-            explicit havINIData(
-#ifndef HAVINI_CASE_SENSITIVE
-            const std::locale& loc,
-#endif
-            const std::string& key, havINIDataType valueType = havINIDataType::Empty, bool addQuotes = false, bool hasArrayIndex = false) :
-#ifndef HAVINI_CASE_SENSITIVE
-            mLocale(loc),
-#endif
-            mType(valueType), mKey(key), mValue(""), mInlineComment(std::nullopt), mAddQuotes(addQuotes), mArrayIndex(0), mHasArrayIndex(hasArrayIndex)
-            {
-            }
+                    if (mPendingSize > 0)
+                    {
+                        std::size_t count = std::min(value.size(), sizeof(mPending) - mPendingSize);
 
-            explicit havINIData(havINIData&& value) :
-#ifndef HAVINI_CASE_SENSITIVE
-            mLocale(value.mLocale),
-#endif
-            mType(value.mType), mKey(value.mKey), mValue(value.mValue), mInlineComment(value.mInlineComment), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(value.mArray)
-            {
-            }
+                        std::memcpy(mPending + mPendingSize, value.data(), count);
+                        mPendingSize += count;
+                        value.remove_prefix(count);
 
-            explicit havINIData(const havINIData& value) :
-#ifndef HAVINI_CASE_SENSITIVE
-            mLocale(value.mLocale),
-#endif
-            mType(value.mType), mKey(value.mKey), mValue(value.mValue), mInlineComment(value.mInlineComment), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(value.mArray)
-            {
-            }
+                        if (mPendingSize < sizeof(mPending))
+                        {
+                            return;
+                        }
 
-            havINIData& operator=(havINIData&& value)
-            {
-#ifndef HAVINI_CASE_SENSITIVE
-                mLocale = value.mLocale;
-#endif
-                mKey = value.mKey;
-                mValue = value.mValue;
-                mType = value.mType;
-                mInlineComment = value.mInlineComment;
-                mAddQuotes = value.mAddQuotes;
-                mArrayIndex = value.mArrayIndex;
-                mHasArrayIndex = value.mHasArrayIndex;
-                mArray = value.mArray;
+                        AddBlock(mPending);
+                        mPendingSize = 0;
+                    }
 
-                return *this;
-            }
+                    for (; value.size() >= sizeof(mPending); value.remove_prefix(sizeof(mPending)))
+                    {
+                        AddBlock(value.data());
+                    }
 
-            havINIData& operator=(const havINIData& value)
-            {
-                if (this != &value)
+                    if (value.empty() == false)
+                    {
+                        std::memcpy(mPending, value.data(), value.size());
+                        mPendingSize = value.size();
+                    }
+                }
+
+                std::uint64_t GetHash() const
                 {
-#ifndef HAVINI_CASE_SENSITIVE
-                    mLocale = value.mLocale;
-#endif
-                    mKey = value.mKey;
-                    mValue = value.mValue;
-                    mType = value.mType;
-                    mInlineComment = value.mInlineComment;
-                    mAddQuotes = value.mAddQuotes;
-                    mArrayIndex = value.mArrayIndex;
-                    mHasArrayIndex = value.mHasArrayIndex;
-                    mArray = value.mArray;
+                    std::uint64_t hash = mLanes[0];
+
+                    for (std::size_t lane = 1; lane < 4; ++lane)
+                    {
+                        hash = (hash ^ mLanes[lane]) * multiplier;
+                        hash ^= hash >> 29;
+                    }
+
+                    for (std::size_t index = 0; index < mPendingSize; ++index)
+                    {
+                        hash ^= static_cast<unsigned char>(mPending[index]);
+                        hash *= 1099511628211ull;
+                    }
+
+                    hash = (hash ^ mSize) * multiplier;
+                    hash ^= hash >> 29;
+
+                    return hash;
                 }
 
-                return *this;
-            }
+            private:
+                void AddBlock(const char* block)
+                {
+                    for (std::size_t lane = 0; lane < 4; ++lane)
+                    {
+                        std::uint64_t word;
+                        std::memcpy(&word, block + lane * 8, sizeof(word));
 
-            bool operator==(const havINIData& value) const
-            {
-                return (
-#ifndef HAVINI_CASE_SENSITIVE
-                    mLocale == value.mLocale &&
-#endif
-                    mKey == value.mKey &&
-                    mValue == value.mValue &&
-                    mType == value.mType &&
-                    mInlineComment == value.mInlineComment &&
-                    mAddQuotes == value.mAddQuotes &&
-                    mArrayIndex == value.mArrayIndex &&
-                    mHasArrayIndex == value.mHasArrayIndex &&
-                    compareVectors(mArray, value.mArray));
-            }
+                        mLanes[lane] = (mLanes[lane] ^ word) * multiplier;
+                        mLanes[lane] ^= mLanes[lane] >> 29;
+                    }
+                }
 
-            bool compareVectors(const std::vector<havINIData>& vector1, const std::vector<havINIData>& vector2) const
-            {
-                return vector1.size() == vector2.size() && std::equal(vector1.begin(), vector1.end(), vector2.begin());
-            }
+                static constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
 
-            void operator=(const char* value)
+                std::uint64_t mLanes[4] = { 14695981039346656037ull, 0x243f6a8885a308d3ull, 0x13198a2e03707344ull, 0xa4093822299f31d0ull };
+                char mPending[32];
+                std::size_t mPendingSize = 0;
+                std::uint64_t mSize = 0;
+        };
+
+        inline std::uint64_t HashBytes(std::string_view value)
+        {
+            havINIHasher hasher;
+            hasher.Append(value);
+
+            return hasher.GetHash();
+        }
+
+        // FNV-1a hash of the name with ASCII letters folded, usable at compile time. The hash continues from hash, so names can be chained.
+        constexpr std::uint64_t HashName(std::string_view value, std::uint64_t hash = 14695981039346656037ull)
+        {
+            for (char currentChar : value)
             {
-                mValue = value;
+                hash = (hash ^ static_cast<unsigned char>(ToLower(currentChar))) * 1099511628211ull;
             }
 
-            void operator=(const std::string& value)
+            return hash;
+        }
+
+        inline std::string ToLower(std::string value)
+        {
+            for (char& currentChar : value)
             {
-                mValue = value;
+                currentChar = ToLower(currentChar);
             }
 
-            havINIData& operator[](int index)
+            return value;
+        }
+
+        inline std::string ToLower(std::string value, const std::locale& loc)
+        {
+            const auto& ctype = std::use_facet<std::ctype<char>>(loc);
+            std::transform(value.begin(), value.end(), value.begin(), [&ctype](char currentChar) {
+                return ctype.tolower(currentChar);
+            });
+            return value;
+        }
+
+#if defined(HAVINI_SIMD_SSE2) || defined(HAVINI_SIMD_NEON)
+        inline unsigned int CountTrailingZeros(std::uint64_t value)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return static_cast<unsigned int>(index);
+#else
+            return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+        }
+#endif
+
+        // Returns the index of the next character, which is one of the characters (At most 8), an ASCII space or control character (If stopAtSpace is true) or a non-ASCII character (If stopAtNonASCII is true)
+        // Returns the size of the text, if there is no such character. Everything in between can be copied in bulk by the parser.
+        inline std::size_t FindNextStructuralCharacter(std::string_view text, std::size_t index, std::string_view characters, bool stopAtSpace, bool stopAtNonASCII)
+        {
+            const char* data = text.data();
+            const std::size_t size = text.size();
+
+#if defined(HAVINI_SIMD_SSE2) || defined(HAVINI_SIMD_NEON)
+            if (characters.size() <= 8)
             {
-                if (mType != havINIDataType::Array)
+#if defined(HAVINI_SIMD_AVX2)
+                __m256i wideNeedles[8];
+
+                for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
                 {
-                    throw std::runtime_error("Property is not an array!");
+                    wideNeedles[needleIndex] = _mm256_set1_epi8(characters[needleIndex]);
                 }
 
-                if (index < 0 || index >= mArray.size())
+                for (; index + 32 <= size; index += 32)
                 {
-                    throw std::out_of_range("Index is out of range!");
-                }
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+                    __m256i matches = _mm256_setzero_si256();
 
-                return mArray[index];
-            }
+                    for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
+                    {
+                        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, wideNeedles[needleIndex]));
+                    }
 
-            havINIData& operator[](char key)
-            {
-                if (mType != havINIDataType::Array)
-                {
-                    throw std::runtime_error("Property is not an array!");
-                }
+                    if (stopAtSpace == true && stopAtNonASCII == true)
+                    {
+                        // Non-ASCII characters are negative in a signed comparison
+                        matches = _mm256_or_si256(matches, _mm256_cmpgt_epi8(_mm256_set1_epi8(0x21), block));
+                    }
+                    else if (stopAtSpace == true)
+                    {
+                        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8(0x20)), block));
+                    }
+                    else if (stopAtNonASCII == true)
+                    {
+                        matches = _mm256_or_si256(matches, _mm256_cmpgt_epi8(_mm256_setzero_si256(), block));
+                    }
 
-                std::string tempKey{ key };
+                    unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches));
 
-#ifndef HAVINI_CASE_SENSITIVE
-                tempKey = havUtils::ToLower(tempKey, mLocale);
+                    if (mask != 0)
+                    {
+                        return index + CountTrailingZeros(mask);
+                    }
+                }
 #endif
 
-                auto foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+#if defined(HAVINI_SIMD_SSE2)
+                __m128i needles[8];
 
-                if (foundKeyValuePair == mArray.end())
+                for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
                 {
-#ifdef HAVINI_CASE_SENSITIVE
-                    mArray.emplace_back(tempKey, havINIDataType::Value);
-#else
-                    mArray.emplace_back(mLocale, tempKey, havINIDataType::Value);
-#endif
-                    foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+                    needles[needleIndex] = _mm_set1_epi8(characters[needleIndex]);
                 }
 
-                return *foundKeyValuePair;
-            }
-
-            havINIData& operator[](const char* key)
-            {
-                if (mType != havINIDataType::Array)
+                for (; index + 16 <= size; index += 16)
                 {
-                    throw std::runtime_error("Property is not an array!");
-                }
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+                    __m128i matches = _mm_setzero_si128();
 
-                std::string tempKey{ key };
+                    for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
+                    {
+                        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[needleIndex]));
+                    }
 
-#ifndef HAVINI_CASE_SENSITIVE
-                tempKey = havUtils::ToLower(tempKey, mLocale);
-#endif
+                    if (stopAtSpace == true && stopAtNonASCII == true)
+                    {
+                        // Non-ASCII characters are negative in a signed comparison
+                        matches = _mm_or_si128(matches, _mm_cmplt_epi8(block, _mm_set1_epi8(0x21)));
+                    }
+                    else if (stopAtSpace == true)
+                    {
+                        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(0x20)), block));
+                    }
+                    else if (stopAtNonASCII == true)
+                    {
+                        matches = _mm_or_si128(matches, _mm_cmplt_epi8(block, _mm_setzero_si128()));
+                    }
 
-                auto foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+                    unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
 
-                if (foundKeyValuePair == mArray.end())
-                {
-#ifdef HAVINI_CASE_SENSITIVE
-                    mArray.emplace_back(tempKey, havINIDataType::Value);
-#else
-                    mArray.emplace_back(mLocale, tempKey, havINIDataType::Value);
-#endif
-                    foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+                    if (mask != 0)
+                    {
+                        return index + CountTrailingZeros(mask);
+                    }
                 }
+#elif defined(HAVINI_SIMD_NEON)
+                uint8x16_t needles[8];
 
-                return *foundKeyValuePair;
-            }
-
-            havINIData& operator[](std::string key)
-            {
-                if (mType != havINIDataType::Array)
+                for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
                 {
-                    throw std::runtime_error("Property is not an array!");
+                    needles[needleIndex] = vdupq_n_u8(static_cast<std::uint8_t>(characters[needleIndex]));
                 }
 
-#ifndef HAVINI_CASE_SENSITIVE
-                key = havUtils::ToLower(key, mLocale);
-#endif
+                for (; index + 16 <= size; index += 16)
+                {
+                    uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + index));
+                    uint8x16_t matches = vdupq_n_u8(0);
 
-                auto foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+                    for (std::size_t needleIndex = 0; needleIndex < characters.size(); ++needleIndex)
+                    {
+                        matches = vorrq_u8(matches, vceqq_u8(block, needles[needleIndex]));
+                    }
 
-                if (foundKeyValuePair == mArray.end())
-                {
-#ifdef HAVINI_CASE_SENSITIVE
-                    mArray.emplace_back(key, havINIDataType::Value);
-#else
-                    mArray.emplace_back(mLocale, key, havINIDataType::Value);
-#endif
-                    foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
-                }
+                    if (stopAtSpace == true)
+                    {
+                        matches = vorrq_u8(matches, vcleq_u8(block, vdupq_n_u8(0x20)));
+                    }
 
-                return *foundKeyValuePair;
+                    if (stopAtNonASCII == true)
+                    {
+                        matches = vorrq_u8(matches, vcgeq_u8(block, vdupq_n_u8(0x80)));
+                    }
+
+                    // Narrow every byte of the comparison result to 4 bits, so the first match can be found with a 64-bit bit scan
+                    std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+                    if (mask != 0)
+                    {
+                        return index + (CountTrailingZeros(mask) >> 2);
+                    }
+                }
+#endif
             }
+#endif
 
-            std::vector<std::string> Split(const std::string& delimiter)
+            for (; index < size; ++index)
             {
-                if (mType == havINIDataType::Array)
+                unsigned char currentChar = static_cast<unsigned char>(data[index]);
+
+                if ((stopAtSpace == true && currentChar <= 0x20) || (stopAtNonASCII == true && currentChar >= 0x80) || characters.find(data[index]) != std::string_view::npos)
                 {
-                    throw std::runtime_error("Split is not supported by a property of type array!");
+                    return index;
                 }
-
-                return havUtils::Split(mValue, delimiter);
             }
 
-            void Join(const std::vector<std::string>& values, const std::string& delimiter)
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    throw std::runtime_error("Join is not supported by a property of type array!");
-                }
-
-                std::string result = havUtils::Join(values, delimiter);
+            return size;
+        }
 
-                SetValue(result);
+        // Writes the UTF-8 sequence of the code point and returns the position behind it
+        inline char* AppendUTF8(char* output, std::uint32_t codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                *output++ = static_cast<char>(codePoint);
             }
-
-#ifndef HAVINI_CASE_SENSITIVE
-            const std::locale& GetLocale() const { return mLocale; }
-#endif
-            const std::string& GetKey() const { return mKey; }
-            havINIDataType GetType() const { return mType; }
-            const std::string& GetValue() const { return mValue; }
-            std::string GetInlineComment() const
+            else if (codePoint < 0x800)
             {
-                if (HasInlineComment() == false)
-                {
-                    return "";
-                }
-                return mInlineComment.value();
+                *output++ = static_cast<char>((codePoint >> 6) | 0xc0);
+                *output++ = static_cast<char>((codePoint & 0x3f) | 0x80);
+            }
+            else if (codePoint < 0x10000)
+            {
+                *output++ = static_cast<char>((codePoint >> 12) | 0xe0);
+                *output++ = static_cast<char>(((codePoint >> 6) & 0x3f) | 0x80);
+                *output++ = static_cast<char>((codePoint & 0x3f) | 0x80);
+            }
+            else
+            {
+                *output++ = static_cast<char>((codePoint >> 18) | 0xf0);
+                *output++ = static_cast<char>(((codePoint >> 12) & 0x3f) | 0x80);
+                *output++ = static_cast<char>(((codePoint >> 6) & 0x3f) | 0x80);
+                *output++ = static_cast<char>((codePoint & 0x3f) | 0x80);
             }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            void SetLocale(const std::locale& loc) { mLocale = loc; }
-#endif
+            return output;
+        }
 
-            void SetValue(const std::string& value) { mValue = value; }
+        // Reads the UTF-8 sequence at index and moves the index behind it, overlong sequences, surrogates and code points above 0x10ffff are rejected
+        inline std::uint32_t DecodeUTF8(std::string_view text, std::size_t& index)
+        {
+            unsigned char leadByte = static_cast<unsigned char>(text[index++]);
 
-            void SetArrayEntry(std::string key, const std::string& value, bool addQuotes, bool setInlineComment, const std::string& inlineComment = "")
+            if (leadByte < 0x80)
             {
-                if (key.empty() == true)
-                {
-                    key = std::to_string(GetArrayIndex());
-                }
-
-#ifndef HAVINI_CASE_SENSITIVE
-                key = havUtils::ToLower(key, mLocale);
-#endif
-
-                auto foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+                return leadByte;
+            }
 
-                if (foundKeyValuePair == mArray.end())
-                {
-#ifdef HAVINI_CASE_SENSITIVE
-                    mArray.emplace_back(key, value, havINIDataType::Value);
-#else
-                    mArray.emplace_back(mLocale, key, value, havINIDataType::Value);
-#endif
+            std::size_t continuationBytes = 0;
+            std::uint32_t codePoint = 0;
+            std::uint32_t minimumCodePoint = 0;
 
-                    if (setInlineComment == true)
-                    {
-                        foundKeyValuePair = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
-                        foundKeyValuePair->SetInlineComment(inlineComment);
-                        foundKeyValuePair->SetAddQuotes(addQuotes);
-                    }
-                }
-                else
-                {
-                    foundKeyValuePair->SetValue(value);
-                    foundKeyValuePair->SetInlineComment(inlineComment);
-                    foundKeyValuePair->SetAddQuotes(addQuotes);
-                }
+            if ((leadByte & 0xe0) == 0xc0)
+            {
+                continuationBytes = 1;
+                codePoint = leadByte & 0x1f;
+                minimumCodePoint = 0x80;
             }
-
-            void ArrayClear()
+            else if ((leadByte & 0xf0) == 0xe0)
             {
-                if (mType == havINIDataType::Array)
-                {
-                    mArray.clear();
-
-                    return;
-                }
-
-                throw std::runtime_error("Data is not of type array!");
+                continuationBytes = 2;
+                codePoint = leadByte & 0x0f;
+                minimumCodePoint = 0x800;
             }
-
-            bool ArrayEmpty()
+            else if ((leadByte & 0xf8) == 0xf0)
             {
-                if (mType == havINIDataType::Array)
-                {
-                    return mArray.empty();
-                }
-
-                throw std::runtime_error("Data is not of type array!");
+                continuationBytes = 3;
+                codePoint = leadByte & 0x07;
+                minimumCodePoint = 0x10000;
             }
-
-            void ArrayErase(std::vector<havINIData>::iterator itr)
+            else
             {
-                if (mType == havINIDataType::Array)
-                {
-                    mArray.erase(itr);
-
-                    return;
-                }
-
-                throw std::runtime_error("Data is not of type array!");
+                throw std::range_error("Invalid UTF-8 sequence!");
             }
 
-            std::vector<havINIData>::const_iterator ArrayCBegin() const
+            if (index + continuationBytes > text.size())
             {
-                if (mType == havINIDataType::Array)
-                {
-                    return mArray.cbegin();
-                }
-
-                throw std::runtime_error("Data is not of type array!");
+                throw std::range_error("Incomplete UTF-8 sequence!");
             }
 
-            std::vector<havINIData>::const_iterator ArrayCEnd() const
+            for (std::size_t byteIndex = 0; byteIndex < continuationBytes; ++byteIndex)
             {
-                if (mType == havINIDataType::Array)
+                unsigned char currentByte = static_cast<unsigned char>(text[index++]);
+
+                if ((currentByte & 0xc0) != 0x80)
                 {
-                    return mArray.cend();
+                    throw std::range_error("Invalid UTF-8 sequence!");
                 }
 
-                throw std::runtime_error("Data is not of type array!");
+                codePoint = (codePoint << 6) | (currentByte & 0x3f);
             }
 
-            std::vector<havINIData>::iterator ArrayBegin()
+            if (codePoint < minimumCodePoint || codePoint > 0x10ffff || (codePoint >= 0xd800 && codePoint <= 0xdfff))
             {
-                if (mType == havINIDataType::Array)
-                {
-                    return mArray.begin();
-                }
-
-                throw std::runtime_error("Data is not of type array!");
+                throw std::range_error("Invalid UTF-8 sequence!");
             }
 
-            std::vector<havINIData>::iterator ArrayEnd()
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    return mArray.end();
-                }
+            return codePoint;
+        }
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+        // Converts UTF-16 data to UTF-8 in one pass, the byte order is applied while reading. A trailing odd byte and an incomplete surrogate pair at the end are ignored.
+        inline std::string UTF16ToUTF8(const void* data, std::size_t size, bool bigEndian)
+        {
+            const unsigned char* input = static_cast<const unsigned char*>(data);
+            const std::size_t unitCount = size / 2;
 
-            havINIData& ArrayFront()
+            std::string result;
+
+            // Every UTF-16 code unit results in at most 3 bytes, a surrogate pair in 4 bytes
+            result.resize(unitCount * 3);
+
+            char* output = &result[0];
+
+            auto readUnit = [input, bigEndian](std::size_t unitIndex) -> std::uint32_t {
+                const unsigned char* bytes = input + unitIndex * 2;
+                return (bigEndian == true) ? ((bytes[0] << 8) | bytes[1]) : (bytes[0] | (bytes[1] << 8));
+            };
+
+            std::size_t index = 0;
+
+            while (index < unitCount)
             {
-                try
+#if defined(HAVINI_SIMD_SSE2)
+                // Blocks of 8 ASCII characters are narrowed at once
+                if (index + 8 <= unitCount)
                 {
-                    if (mType != havINIDataType::Array)
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index * 2));
+
+                    if (bigEndian == true)
                     {
-                        throw std::runtime_error("Data is not of type array!");
+                        block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
                     }
 
-                    return mArray.front();
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, _mm_set1_epi16(static_cast<short>(0xff80))), _mm_setzero_si128())) == 0xffff)
+                    {
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(block, block));
+
+                        output += 8;
+                        index += 8;
+
+                        continue;
+                    }
                 }
-                catch (const std::out_of_range& ex)
+#elif defined(HAVINI_SIMD_NEON)
+                // Blocks of 8 ASCII characters are narrowed at once
+                if (index + 8 <= unitCount)
                 {
-                    std::cout << "Exception thrown after calling front method of array!\n";
+                    uint8x16_t bytes = vld1q_u8(input + index * 2);
 
-                    throw;
+                    if (bigEndian == true)
+                    {
+                        bytes = vrev16q_u8(bytes);
+                    }
+
+                    uint16x8_t block = vreinterpretq_u16_u8(bytes);
+
+                    if (vmaxvq_u16(block) < 0x80)
+                    {
+                        vst1_u8(reinterpret_cast<std::uint8_t*>(output), vmovn_u16(block));
+
+                        output += 8;
+                        index += 8;
+
+                        continue;
+                    }
                 }
-            }
+#endif
 
-            havINIData& ArrayBack()
-            {
-                try
+                std::uint32_t codePoint = readUnit(index++);
+
+                if (codePoint >= 0xd800 && codePoint <= 0xdbff)
                 {
-                    if (mType != havINIDataType::Array)
+                    if (index == unitCount)
                     {
-                        throw std::runtime_error("Data is not of type array!");
+                        break;
                     }
 
-                    return mArray.back();
+                    std::uint32_t lowSurrogate = readUnit(index++);
+
+                    if (lowSurrogate < 0xdc00 || lowSurrogate > 0xdfff)
+                    {
+                        throw std::range_error("Invalid UTF-16 surrogate pair!");
+                    }
+
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
                 }
-                catch (const std::out_of_range& ex)
+                else if (codePoint >= 0xdc00 && codePoint <= 0xdfff)
                 {
-                    std::cout << "Exception thrown after calling back method of array!\n";
-
-                    throw;
+                    throw std::range_error("Invalid UTF-16 surrogate pair!");
                 }
+
+                output = AppendUTF8(output, codePoint);
             }
 
-            void ArrayInsert(unsigned int index, const havINIData& newValue)
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    auto itr = mArray.begin();
+            result.resize(output - result.data());
 
-                    mArray.insert(itr + index, newValue);
+            return result;
+        }
 
-                    return;
-                }
+        // Converts UTF-32 data to UTF-8 in one pass, the byte order is applied while reading. Trailing bytes which don't form a complete code unit are ignored.
+        inline std::string UTF32ToUTF8(const void* data, std::size_t size, bool bigEndian)
+        {
+            const unsigned char* input = static_cast<const unsigned char*>(data);
+            const std::size_t unitCount = size / 4;
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+            std::string result;
+            result.resize(unitCount * 4);
 
-            void ArrayPushBack(const havINIData& newValue)
+            char* output = &result[0];
+
+            for (std::size_t index = 0; index < unitCount; ++index)
             {
-                if (mType == havINIDataType::Array)
-                {
-                    mArray.push_back(newValue);
+                const unsigned char* bytes = input + index * 4;
 
-                    return;
+                std::uint32_t codePoint = (bigEndian == true) ?
+                    ((static_cast<std::uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3]) :
+                    (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24));
+
+                if (codePoint > 0x10ffff)
+                {
+                    throw std::range_error("Invalid UTF-32 code point!");
                 }
 
-                throw std::runtime_error("Data is not of type array!");
+                output = AppendUTF8(output, codePoint);
             }
 
-            void ArrayPushFront(const havINIData& newValue)
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    auto itr = mArray.begin();
+            result.resize(output - result.data());
 
-                    mArray.insert(itr, newValue);
+            return result;
+        }
 
-                    return;
-                }
+        // Converts UTF-8 data to UTF-16 bytes in the specified byte order in one pass, optionally with the BOM in front
+        inline std::string UTF8ToUTF16(std::string_view text, bool bigEndian, bool writeBOM)
+        {
+            std::string result;
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+            // Every UTF-8 byte results in at most 2 bytes
+            result.resize((text.size() + 1) * 2);
 
-            void ArrayPopBack()
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    if (mArray.empty() == false)
-                    {
-                        mArray.pop_back();
-                    }
+            unsigned char* output = reinterpret_cast<unsigned char*>(&result[0]);
 
-                    return;
+            auto writeUnit = [&output, bigEndian](std::uint32_t unit) {
+                if (bigEndian == true)
+                {
+                    *output++ = static_cast<unsigned char>(unit >> 8);
+                    *output++ = static_cast<unsigned char>(unit & 0xff);
+                }
+                else
+                {
+                    *output++ = static_cast<unsigned char>(unit & 0xff);
+                    *output++ = static_cast<unsigned char>(unit >> 8);
                 }
+            };
 
-                throw std::runtime_error("Data is not of type array!");
+            if (writeBOM == true)
+            {
+                writeUnit(0xfeff);
             }
 
-            void ArrayPopFront()
+            std::size_t index = 0;
+
+            while (index < text.size())
             {
-                if (mType == havINIDataType::Array)
+#if defined(HAVINI_SIMD_SSE2)
+                // Blocks of 16 ASCII characters are widened at once
+                if (index + 16 <= text.size())
                 {
-                    if (mArray.empty() == false)
-                    {
-                        auto itr = mArray.begin();
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + index));
 
-                        mArray.erase(itr);
-                    }
+                    if (_mm_movemask_epi8(block) == 0)
+                    {
+                        __m128i zero = _mm_setzero_si128();
 
-                    return;
-                }
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), (bigEndian == true) ? _mm_unpacklo_epi8(zero, block) : _mm_unpacklo_epi8(block, zero));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16), (bigEndian == true) ? _mm_unpackhi_epi8(zero, block) : _mm_unpackhi_epi8(block, zero));
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+                        output += 32;
+                        index += 16;
 
-            void ArrayRemove(unsigned int index)
-            {
-                if (mType == havINIDataType::Array)
+                        continue;
+                    }
+                }
+#elif defined(HAVINI_SIMD_NEON)
+                // Blocks of 16 ASCII characters are widened at once
+                if (index + 16 <= text.size())
                 {
-                    if (mArray.empty() == false)
+                    uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(text.data() + index));
+
+                    if (vmaxvq_u8(block) < 0x80)
                     {
-                        auto itr = mArray.begin();
+                        uint8x16x2_t units = (bigEndian == true) ? uint8x16x2_t{ { vdupq_n_u8(0), block } } : uint8x16x2_t{ { block, vdupq_n_u8(0) } };
 
-                        mArray.erase(itr + index);
-                    }
+                        vst2q_u8(output, units);
 
-                    return;
+                        output += 32;
+                        index += 16;
+
+                        continue;
+                    }
                 }
+#endif
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+                std::uint32_t codePoint = DecodeUTF8(text, index);
 
-            void ArrayRemove(std::string keyName)
-            {
-                if (mType == havINIDataType::Array)
+                if (codePoint >= 0x10000)
                 {
-#ifndef HAVINI_CASE_SENSITIVE
-                    keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                    codePoint -= 0x10000;
 
-                    auto itr = std::find_if(mArray.begin(), mArray.end(), [&](const havINIData& data) { return data.GetKey() == keyName; } );
+                    writeUnit(0xd800 + (codePoint >> 10));
+                    writeUnit(0xdc00 + (codePoint & 0x3ff));
+                }
+                else
+                {
+                    writeUnit(codePoint);
+                }
+            }
 
-                    if (itr == mArray.end())
-                    {
-                        throw std::runtime_error("Provided key could not be found in array!");
-                    }
+            result.resize(reinterpret_cast<char*>(output) - result.data());
 
-                    mArray.erase(itr);
+            return result;
+        }
 
-                    return;
-                }
+        // Converts UTF-8 data to UTF-32 bytes in the specified byte order in one pass, optionally with the BOM in front
+        inline std::string UTF8ToUTF32(std::string_view text, bool bigEndian, bool writeBOM)
+        {
+            std::string result;
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+            // Every UTF-8 byte results in at most 4 bytes
+            result.resize((text.size() + 1) * 4);
 
-            bool ArrayContains(const havINIData& value)
-            {
-                if (mType == havINIDataType::Array)
+            unsigned char* output = reinterpret_cast<unsigned char*>(&result[0]);
+
+            auto writeUnit = [&output, bigEndian](std::uint32_t unit) {
+                if (bigEndian == true)
                 {
-                    return std::find(mArray.begin(), mArray.end(), value) != mArray.end();
+                    *output++ = static_cast<unsigned char>(unit >> 24);
+                    *output++ = static_cast<unsigned char>((unit >> 16) & 0xff);
+                    *output++ = static_cast<unsigned char>((unit >> 8) & 0xff);
+                    *output++ = static_cast<unsigned char>(unit & 0xff);
                 }
+                else
+                {
+                    *output++ = static_cast<unsigned char>(unit & 0xff);
+                    *output++ = static_cast<unsigned char>((unit >> 8) & 0xff);
+                    *output++ = static_cast<unsigned char>((unit >> 16) & 0xff);
+                    *output++ = static_cast<unsigned char>(unit >> 24);
+                }
+            };
 
-                throw std::runtime_error("Data is not of type array!");
+            if (writeBOM == true)
+            {
+                writeUnit(0xfeff);
             }
 
-            havINIData& ArrayAt(unsigned int index)
+            std::size_t index = 0;
+
+            while (index < text.size())
             {
-                try
-                {
-                    if (mType != havINIDataType::Array)
-                    {
-                        throw std::runtime_error("Data is not of type array!");
-                    }
-
-                    return mArray.at(index);
-                }
-                catch (const std::out_of_range& ex)
-                {
-                    std::cout << "Exception thrown after calling at method of array!\n";
-
-                    throw;
-                }
+                writeUnit(DecodeUTF8(text, index));
             }
 
-            std::vector<havINIData>::size_type ArraySize()
-            {
-                if (mType == havINIDataType::Array)
-                {
-                    return mArray.size();
-                }
+            result.resize(reinterpret_cast<char*>(output) - result.data());
 
-                throw std::runtime_error("Data is not of type array!");
-            }
+            return result;
+        }
 
-            bool HasInlineComment() const { return mInlineComment.has_value(); }
-            void SetInlineComment(const std::string& inlineComment)
-            {
-                if (inlineComment.empty() == true)
-                {
-                    mInlineComment = std::nullopt;
+        // Type a value is parsed into before it is narrowed to the requested type, so one cached result serves all integer widths
+        template<typename T, typename = void>
+        struct FromCharsType;
 
-                    return;
-                }
+        template<typename T>
+        struct FromCharsType<T, std::enable_if_t<std::is_same_v<T, bool>>> { using type = bool; };
 
-                mInlineComment = inlineComment;
-            }
+        template<typename T>
+        struct FromCharsType<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>> { using type = long long; };
 
-            bool GetAddQuotes() const { return mAddQuotes; }
-            void SetAddQuotes(bool addQuotes) { mAddQuotes = addQuotes; }
+        template<typename T>
+        struct FromCharsType<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> && std::is_same_v<T, bool> == false>> { using type = unsigned long long; };
 
-            unsigned int GetArrayIndex()
+        template<typename T>
+        struct FromCharsType<T, std::enable_if_t<std::is_floating_point_v<T>>> { using type = double; };
+
+        // Parses the complete value, decimal and hexadecimal ("0x") integers, floating point numbers and true/false, yes/no, on/off, 1/0 are supported
+        template<typename T>
+        bool FromChars(std::string_view value, T& result)
+        {
+            if constexpr (std::is_same_v<T, bool>)
             {
-                unsigned int arrayIndex = 0;
+                auto equals = [value](std::string_view lowerText) {
+                    return value.size() == lowerText.size() && std::equal(value.begin(), value.end(), lowerText.begin(), [](char valueChar, char textChar) { return ToLower(valueChar) == textChar; });
+                };
 
-                for (const auto& arrayEntry : mArray)
+                if (equals("true") == true || equals("yes") == true || equals("on") == true || equals("1") == true)
                 {
-                    unsigned int arrayKey = std::stol(arrayEntry.GetKey());
-
-                    if (arrayIndex <= arrayKey)
-                    {
-                        arrayIndex = arrayKey + 1;
-                    }
+                    result = true;
+                    return true;
                 }
 
-                mArrayIndex = arrayIndex;
+                if (equals("false") == true || equals("no") == true || equals("off") == true || equals("0") == true)
+                {
+                    result = false;
+                    return true;
+                }
 
-                return mArrayIndex;
+                return false;
             }
-
-            void SetHasArrayIndex(bool hasArrayIndex) { mHasArrayIndex = hasArrayIndex; }
-            bool HasArrayIndex() const { return mHasArrayIndex; }
-
-        private:
-            void SetKey(std::string key)
+            else
             {
-#ifndef HAVINI_CASE_SENSITIVE
-                key = havUtils::ToLower(key, mLocale);
-#endif
-
-                mKey = key;
-            }
-
-            friend class havINISection;
-
-#ifndef HAVINI_CASE_SENSITIVE
-            std::locale mLocale;
-#endif
-            havINIDataType mType;
-            std::string mKey;
-            std::string mValue;
-            std::optional<std::string> mInlineComment;
-            bool mAddQuotes;
+                // std::from_chars does not accept a leading plus sign
+                if (value.size() > 1 && value[0] == '+' && value[1] != '-')
+                {
+                    value.remove_prefix(1);
+                }
 
-            unsigned int mArrayIndex;
-            bool mHasArrayIndex;
-            std::vector<havINIData> mArray;
-    };
+                const char* first = value.data();
+                const char* last = value.data() + value.size();
+                std::from_chars_result parseResult;
 
-    class havINISection
-    {
-    public:
-        explicit havINISection(
-#ifndef HAVINI_CASE_SENSITIVE
-        const std::locale& loc,
-#endif
-        const std::string& sectionName, std::optional<std::string> inlineComment = std::nullopt, const std::vector<havINIData>& keyValuePairs = {}) :
-#ifndef HAVINI_CASE_SENSITIVE
-        mLocale(loc),
-#endif
-        mSectionName(sectionName), mInlineComment(inlineComment), mKeyValuePairs(keyValuePairs), mCommentLineCount(0), mEmptyLineCount(0)
-        {
-        }
+                if constexpr (std::is_integral_v<T>)
+                {
+                    if (value.size() > 2 && (StartsWith(value, "0x") == true || StartsWith(value, "0X") == true))
+                    {
+                        parseResult = std::from_chars(first + 2, last, result, 16);
+                    }
+                    else
+                    {
+                        parseResult = std::from_chars(first, last, result);
+                    }
+                }
+                else
+                {
+                    parseResult = std::from_chars(first, last, result);
+                }
 
-        explicit havINISection(havINISection&& value) :
-#ifndef HAVINI_CASE_SENSITIVE
-        mLocale(value.mLocale),
-#endif
-        mSectionName(value.mSectionName), mInlineComment(value.mInlineComment), mKeyValuePairs(value.mKeyValuePairs), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount)
-        {
+                return value.empty() == false && parseResult.ec == std::errc() && parseResult.ptr == last;
+            }
         }
 
-        explicit havINISection(const havINISection& value) :
-#ifndef HAVINI_CASE_SENSITIVE
-        mLocale(value.mLocale),
-#endif
-        mSectionName(value.mSectionName), mInlineComment(value.mInlineComment), mKeyValuePairs(value.mKeyValuePairs), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount)
+        // Narrows a value parsed by FromChars to T, integers which don't fit into T fail. result is only changed on success.
+        template<typename T>
+        bool ConvertParsedValue(typename FromCharsType<T>::type parsedValue, T& result)
         {
-        }
+            if constexpr (std::is_integral_v<T> == true && std::is_same_v<T, bool> == false)
+            {
+                if (parsedValue < std::numeric_limits<T>::min() || parsedValue > std::numeric_limits<T>::max())
+                {
+                    return false;
+                }
+            }
 
-        havINISection& operator=(havINISection&& value)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            mLocale = value.mLocale;
-#endif
-            mSectionName = value.mSectionName;
-            mInlineComment = value.mInlineComment;
-            mKeyValuePairs = value.mKeyValuePairs;
-            mCommentLineCount = value.mCommentLineCount;
-            mEmptyLineCount = value.mEmptyLineCount;
+            result = static_cast<T>(parsedValue);
 
-            return *this;
+            return true;
         }
 
-        havINISection& operator=(const havINISection& value)
+        // Converts the complete value for GetValueAs of the data, the snapshot and the schema binding, integers which don't fit into T fail as well.
+        // A string takes the value as it is. result is only changed on success.
+        template<typename T>
+        bool ConvertValue(std::string_view value, T& result)
         {
-            if (this != &value)
+            if constexpr (std::is_same_v<T, std::string>)
             {
-#ifndef HAVINI_CASE_SENSITIVE
-                mLocale = value.mLocale;
-#endif
-                mSectionName = value.mSectionName;
-                mInlineComment = value.mInlineComment;
-                mKeyValuePairs = value.mKeyValuePairs;
-                mCommentLineCount = value.mCommentLineCount;
-                mEmptyLineCount = value.mEmptyLineCount;
+                result.assign(value);
+
+                return true;
             }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T> == true && std::is_same_v<T, long double> == false, "Only bool, integer, float, double and std::string values can be converted!");
 
-            return *this;
-        }
+                typename FromCharsType<T>::type parsedValue;
 
-        havINIData& operator[](int index)
-        {
-            if (index < 0 || index >= mKeyValuePairs.size())
-            {
-                throw std::out_of_range("Index is out of range!");
+                return FromChars(value, parsedValue) == true && ConvertParsedValue(parsedValue, result) == true;
             }
-
-            return mKeyValuePairs[index];
         }
+    }
 
-        havINIData& operator[](char key)
-        {
-            std::string tempKey{ key };
+    // Case policies for section names and keys, used as template argument of basic_havINIStream, basic_havINISection and basic_havINIData.
+    // Section names and keys are stored folded, lookups compare and hash the requested name directly instead of folding a copy of it.
+    struct havINICaseSensitivePolicy
+    {
+        static void Fold(std::string&) {}
 
-#ifndef HAVINI_CASE_SENSITIVE
-            tempKey = havUtils::ToLower(tempKey, mLocale);
-#endif
+        static bool Equal(std::string_view value, std::string_view otherValue) { return value == otherValue; }
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+        static std::size_t Hash(std::string_view value) { return std::hash<std::string_view>{}(value); }
+    };
 
-            if (foundKeyValuePair == mKeyValuePairs.end())
+    struct havINICaseInsensitivePolicy
+    {
+        static void Fold(std::string& value)
+        {
+            for (char& currentChar : value)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mKeyValuePairs.emplace_back(tempKey, havINIDataType::Value);
-#else
-                mKeyValuePairs.emplace_back(mLocale, tempKey, havINIDataType::Value);
-#endif
-                foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+                currentChar = havUtils::ToLower(currentChar);
             }
-
-            return *foundKeyValuePair;
         }
 
-        havINIData& operator[](const char* key)
+        static bool Equal(std::string_view value, std::string_view otherValue)
         {
-            std::string tempKey{ key };
-
-#ifndef HAVINI_CASE_SENSITIVE
-            tempKey = havUtils::ToLower(tempKey, mLocale);
-#endif
-
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+            if (value.size() != otherValue.size())
+            {
+                return false;
+            }
 
-            if (foundKeyValuePair == mKeyValuePairs.end())
+            for (std::size_t index = 0; index < value.size(); ++index)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mKeyValuePairs.emplace_back(tempKey, havINIDataType::Value);
-#else
-                mKeyValuePairs.emplace_back(mLocale, tempKey, havINIDataType::Value);
-#endif
-                foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == tempKey; } );
+                if (havUtils::ToLower(value[index]) != havUtils::ToLower(otherValue[index]))
+                {
+                    return false;
+                }
             }
 
-            return *foundKeyValuePair;
+            return true;
         }
 
-        havINIData& operator[](std::string key)
+        // FNV-1a over the folded characters
+        static std::size_t Hash(std::string_view value)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-#endif
+            std::uint64_t hash = 14695981039346656037ull;
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
-
-            if (foundKeyValuePair == mKeyValuePairs.end())
+            for (char currentChar : value)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mKeyValuePairs.emplace_back(key, havINIDataType::Value);
-#else
-                mKeyValuePairs.emplace_back(mLocale, key, havINIDataType::Value);
-#endif
-                foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+                hash ^= static_cast<unsigned char>(havUtils::ToLower(currentChar));
+                hash *= 1099511628211ull;
             }
 
-            return *foundKeyValuePair;
+            return static_cast<std::size_t>(hash);
         }
+    };
 
-        void SetSectionName(std::string sectionName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
+#ifdef HAVINI_CASE_SENSITIVE
+    using havINIDefaultCasePolicy = havINICaseSensitivePolicy;
+#else
+    using havINIDefaultCasePolicy = havINICaseInsensitivePolicy;
 #endif
 
-            mSectionName = sectionName;
-        }
+    // Open addressing hash table which maps keys to their slot in a vector of sections or key value pairs.
+    // Only the hash and the slot are stored, the key itself is always compared against the element in the vector,
+    // so file order is kept by the vector and lookups don't need a copy of the key.
+    template<class CasePolicy, class Allocator = std::allocator<char>>
+    class havINIHashIndex
+    {
+        public:
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-        void SetInlineComment(const std::string& inlineComment)
-        {
-            if (inlineComment.empty() == true)
+            explicit havINIHashIndex(const Allocator& allocator = Allocator()) : mBuckets(allocator)
             {
-                mInlineComment = std::nullopt;
-
-                return;
             }
 
-            mInlineComment = inlineComment;
-        }
-
-        bool SetEmptyLine(std::string key, const havINIPosition& position, std::optional<std::string> otherKeyName = std::nullopt)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-
-            if (otherKeyName.has_value() == true)
+            havINIHashIndex(const havINIHashIndex& value, const Allocator& allocator) :
+            mBuckets(value.mBuckets, allocator), mCount(value.mCount), mValid(value.mValid)
             {
-                otherKeyName = havUtils::ToLower(otherKeyName.value(), mLocale);
             }
-#endif
-
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
 
-            if (foundKeyValuePair == mKeyValuePairs.end())
+            havINIHashIndex(havINIHashIndex&& value, const Allocator& allocator) :
+            mBuckets(std::move(value.mBuckets), allocator), mCount(value.mCount), mValid(value.mValid)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                havINIData newEmptyLine(key, "", havINIDataType::Empty);
-#else
-                havINIData newEmptyLine(mLocale, key, "", havINIDataType::Empty);
-#endif
+            }
 
-                std::ptrdiff_t index = 0;
+            havINIHashIndex(const havINIHashIndex& value) = default;
+            havINIHashIndex(havINIHashIndex&& value) noexcept = default;
+            havINIHashIndex& operator=(const havINIHashIndex& value) = default;
+            havINIHashIndex& operator=(havINIHashIndex&& value) = default;
 
-                if (position == havINIPosition::Above || position == havINIPosition::Below)
+            template<class Container, class KeyOf>
+            std::size_t Find(std::string_view key, const Container& container, KeyOf keyOf)
+            {
+#ifndef HAVINI_NO_HASH_INDEX
+                if (container.size() >= HAVINI_HASH_INDEX_THRESHOLD)
                 {
-                    auto foundOtherKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == otherKeyName; } );
-
-                    if (foundOtherKeyValuePair != mKeyValuePairs.end())
+                    if (mValid == false)
                     {
-                        index = GetIndex((*foundOtherKeyValuePair));
+                        Rebuild(container, keyOf);
                     }
-                    else
+
+                    std::size_t hash = CasePolicy::Hash(key);
+                    std::size_t mask = mBuckets.size() - 1;
+
+                    for (std::size_t bucket = hash & mask; mBuckets[bucket].slot != 0; bucket = (bucket + 1) & mask)
                     {
-                        throw std::runtime_error("\"" + otherKeyName.value() + "\" could not be found!");
+                        if (mBuckets[bucket].hash == hash && CasePolicy::Equal(keyOf(container[mBuckets[bucket].slot - 1]), key) == true)
+                        {
+                            return mBuckets[bucket].slot - 1;
+                        }
                     }
+
+                    return npos;
                 }
+#endif
 
-                switch (position)
+                for (std::size_t slot = 0; slot < container.size(); ++slot)
                 {
-                case havINIPosition::Start:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin(), newEmptyLine);
-                    break;
-
-                case havINIPosition::Above:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin() + index, newEmptyLine);
-                    break;
-
-                case havINIPosition::Below:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin() + index + 1, newEmptyLine);
-                    break;
-
-                case havINIPosition::End:
-                default:
-                    mKeyValuePairs.insert(mKeyValuePairs.end(), newEmptyLine);
-                    break;
+                    if (CasePolicy::Equal(keyOf(container[slot]), key) == true)
+                    {
+                        return slot;
+                    }
                 }
 
-                return true;
+                return npos;
             }
 
-            return false;
-        }
+            // Must be called after an element has been appended to the end of the vector
+            void Insert(std::string_view key, std::size_t slot)
+            {
+                if (mValid == false)
+                {
+                    return;
+                }
 
-        void SetKeyValuePair(std::string key, const std::string& value, bool addQuotes)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-#endif
+                // Keep the load factor below 50%, the next lookup rebuilds the table with more buckets
+                if ((mCount + 1) * 2 > mBuckets.size())
+                {
+                    Invalidate();
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+                    return;
+                }
 
-            if (foundKeyValuePair != mKeyValuePairs.end())
-            {
-                foundKeyValuePair->SetValue(value);
-                foundKeyValuePair->SetAddQuotes(addQuotes);
+                Add(CasePolicy::Hash(key), slot);
             }
-            else
+
+            // Must be called whenever elements are inserted before the end, removed or renamed
+            void Invalidate()
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mKeyValuePairs.emplace_back(key, value, havINIDataType::Value, addQuotes);
-#else
-                mKeyValuePairs.emplace_back(mLocale, key, value, havINIDataType::Value, addQuotes);
-#endif
+                mBuckets.clear();
+                mCount = 0;
+                mValid = false;
             }
-        }
-
-        void SetArrayEntry(std::string key, const std::string& value, bool addQuotes, bool setInlineComment, const std::string& inlineComment = "", const std::string& arrayIndex = "", bool hasArrayIndex = false)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-#endif
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+        private:
+            struct havINIHashBucket
+            {
+                std::size_t hash;
+                std::size_t slot; // Slot + 1, zero marks an empty bucket
+            };
 
-            if (foundKeyValuePair != mKeyValuePairs.end())
+            template<class Container, class KeyOf>
+            void Rebuild(const Container& container, KeyOf keyOf)
             {
-                if (hasArrayIndex == true)
+                std::size_t bucketCount = 16;
+
+                while (bucketCount < container.size() * 2)
                 {
-                    foundKeyValuePair->SetArrayEntry(arrayIndex, value, addQuotes, setInlineComment, inlineComment);
+                    bucketCount *= 2;
                 }
-                else
+
+                mBuckets.assign(bucketCount, havINIHashBucket{ 0, 0 });
+                mCount = 0;
+                mValid = true;
+
+                for (std::size_t slot = 0; slot < container.size(); ++slot)
                 {
-                    foundKeyValuePair->SetArrayEntry("", value, addQuotes, setInlineComment, inlineComment);
+                    Add(CasePolicy::Hash(keyOf(container[slot])), slot);
                 }
             }
-            else
-            {
-#ifdef HAVINI_CASE_SENSITIVE
-                mKeyValuePairs.emplace_back(key, havINIDataType::Array, hasArrayIndex);
-#else
-                mKeyValuePairs.emplace_back(mLocale, key, havINIDataType::Array, hasArrayIndex);
-#endif
 
-                auto foundNewKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
+            void Add(std::size_t hash, std::size_t slot)
+            {
+                std::size_t mask = mBuckets.size() - 1;
+                std::size_t bucket = hash & mask;
 
-                if (hasArrayIndex == true)
-                {
-                    foundNewKeyValuePair->SetArrayEntry(arrayIndex, value, addQuotes, setInlineComment, inlineComment);
-                }
-                else
+                while (mBuckets[bucket].slot != 0)
                 {
-                    foundNewKeyValuePair->SetArrayEntry("", value, addQuotes, setInlineComment, inlineComment);
+                    bucket = (bucket + 1) & mask;
                 }
+
+                mBuckets[bucket] = havINIHashBucket{ hash, slot + 1 };
+                ++mCount;
             }
-        }
 
-        std::ptrdiff_t GetIndex(havINIData& data)
-        {
-            return std::distance(mKeyValuePairs.data(), std::addressof(data));
-        }
+            std::vector<havINIHashBucket, typename std::allocator_traits<Allocator>::template rebind_alloc<havINIHashBucket>> mBuckets;
+            std::size_t mCount = 0;
+            bool mValid = false;
+    };
 
-        bool SetComment(std::string key, const std::string& value, const havINIPosition& position, std::optional<std::string> otherKeyName = std::nullopt)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
+    template<class CasePolicy, class Allocator = std::allocator<char>>
+    class basic_havINISection;
 
-            if (otherKeyName.has_value() == true)
+    template<class CasePolicy, class Allocator = std::allocator<char>>
+    class basic_havINIStream;
+
+    // Allocator is an allocator for char, it is rebound for the nested vectors. With an allocator that does uses-allocator construction (e.g. std::pmr::polymorphic_allocator)
+    // every entry, array entry and string of a document is placed into the memory resource of the stream.
+    template<class CasePolicy, class Allocator = std::allocator<char>>
+    class basic_havINIData
+    {
+        public:
+            using havINIData = basic_havINIData;
+            using havINISection = basic_havINISection<CasePolicy, Allocator>;
+            using allocator_type = Allocator;
+            using havINIString = std::basic_string<char, std::char_traits<char>, Allocator>;
+            using havINIDataVector = std::vector<havINIData, typename std::allocator_traits<Allocator>::template rebind_alloc<havINIData>>;
+
+            explicit basic_havINIData(
+            std::string_view key, std::string_view value, havINIDataType valueType, bool addQuotes = false, std::optional<std::string_view> inlineComment = std::nullopt, bool hasArrayIndex = false) :
+            basic_havINIData(std::allocator_arg, Allocator(), key, value, valueType, addQuotes, inlineComment, hasArrayIndex)
             {
-                otherKeyName = havUtils::ToLower(otherKeyName.value(), mLocale);
             }
-#endif
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
-
-            if (foundKeyValuePair == mKeyValuePairs.end())
+            explicit basic_havINIData(
+            std::string_view key, havINIDataType valueType = havINIDataType::Empty, bool addQuotes = false, bool hasArrayIndex = false) :
+            basic_havINIData(std::allocator_arg, Allocator(), key, valueType, addQuotes, hasArrayIndex)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                havINIData newComment(key, value, havINIDataType::Comment);
+            }
+
+            basic_havINIData(
+            std::allocator_arg_t, const Allocator& allocator, std::string_view key, std::string_view value, havINIDataType valueType, bool addQuotes = false, std::optional<std::string_view> inlineComment = std::nullopt, bool hasArrayIndex = false) :
+            mType(valueType), mKey(key, allocator), mValue(value, allocator), mAddQuotes(addQuotes), mArrayIndex(0), mHasArrayIndex(hasArrayIndex), mArray(allocator), mArrayKeyIndex(allocator)
+            {
+                if (inlineComment.has_value() == true)
+                {
+                    mInlineComment.emplace(inlineComment.value(), allocator);
+                }
+            }
+
+            basic_havINIData(
+            std::allocator_arg_t, const Allocator& allocator, std::string_view key, havINIDataType valueType = havINIDataType::Empty, bool addQuotes = false, bool hasArrayIndex = false) :
+            mType(valueType), mKey(key, allocator), mValue(allocator), mInlineComment(std::nullopt), mAddQuotes(addQuotes), mArrayIndex(0), mHasArrayIndex(hasArrayIndex), mArray(allocator), mArrayKeyIndex(allocator)
+            {
+            }
+
+            // Moving only transfers the buffers, so growing the vectors of sections, key value pairs and arrays never copies whole subtrees
+            basic_havINIData(havINIData&& value) noexcept :
+            mType(value.mType), mKey(std::move(value.mKey)), mValue(std::move(value.mValue)), mInlineComment(std::move(value.mInlineComment)), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasValidArrayIndex(value.mHasValidArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(std::move(value.mArray)), mArrayKeyIndex(std::move(value.mArrayKeyIndex)), mCachedValue(value.mCachedValue)
+            {
+            }
+
+            basic_havINIData(const havINIData& value) :
+            mType(value.mType), mKey(value.mKey), mValue(value.mValue), mInlineComment(value.mInlineComment), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasValidArrayIndex(value.mHasValidArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(value.mArray), mArrayKeyIndex(value.mArrayKeyIndex), mCachedValue(value.mCachedValue)
+            {
+            }
+
+            // Used by the vectors to move or copy entries into their own memory
+            basic_havINIData(std::allocator_arg_t, const Allocator& allocator, havINIData&& value) :
+            mType(value.mType), mKey(std::move(value.mKey), allocator), mValue(std::move(value.mValue), allocator), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasValidArrayIndex(value.mHasValidArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(std::move(value.mArray), allocator), mArrayKeyIndex(std::move(value.mArrayKeyIndex), allocator), mCachedValue(value.mCachedValue)
+            {
+                if (value.mInlineComment.has_value() == true)
+                {
+                    mInlineComment.emplace(std::move(value.mInlineComment.value()), allocator);
+                }
+            }
+
+            basic_havINIData(std::allocator_arg_t, const Allocator& allocator, const havINIData& value) :
+            mType(value.mType), mKey(value.mKey, allocator), mValue(value.mValue, allocator), mAddQuotes(value.mAddQuotes), mArrayIndex(value.mArrayIndex), mHasValidArrayIndex(value.mHasValidArrayIndex), mHasArrayIndex(value.mHasArrayIndex), mArray(value.mArray, allocator), mArrayKeyIndex(value.mArrayKeyIndex, allocator), mCachedValue(value.mCachedValue)
+            {
+                if (value.mInlineComment.has_value() == true)
+                {
+                    mInlineComment.emplace(value.mInlineComment.value(), allocator);
+                }
+            }
+
+            havINIData& operator=(havINIData&& value) noexcept(std::allocator_traits<Allocator>::is_always_equal::value)
+            {
+                if (this != &value)
+                {
+                    mKey = std::move(value.mKey);
+                    mValue = std::move(value.mValue);
+                    mType = value.mType;
+                    mInlineComment = std::move(value.mInlineComment);
+                    mAddQuotes = value.mAddQuotes;
+                    mArrayIndex = value.mArrayIndex;
+                    mHasValidArrayIndex = value.mHasValidArrayIndex;
+                    mHasArrayIndex = value.mHasArrayIndex;
+                    mArray = std::move(value.mArray);
+                    mArrayKeyIndex = std::move(value.mArrayKeyIndex);
+                    mCachedValue = value.mCachedValue;
+                    MarkModified();
+                }
+
+                return *this;
+            }
+
+            havINIData& operator=(const havINIData& value)
+            {
+                if (this != &value)
+                {
+                    mKey = value.mKey;
+                    mValue = value.mValue;
+                    mType = value.mType;
+                    mInlineComment = value.mInlineComment;
+                    mAddQuotes = value.mAddQuotes;
+                    mArrayIndex = value.mArrayIndex;
+                    mHasValidArrayIndex = value.mHasValidArrayIndex;
+                    mHasArrayIndex = value.mHasArrayIndex;
+                    mArray = value.mArray;
+                    mArrayKeyIndex = value.mArrayKeyIndex;
+                    mCachedValue = value.mCachedValue;
+                    MarkModified();
+                }
+
+                return *this;
+            }
+
+            bool operator==(const havINIData& value) const
+            {
+                return (
+                    mKey == value.mKey &&
+                    mValue == value.mValue &&
+                    mType == value.mType &&
+                    mInlineComment == value.mInlineComment &&
+                    mAddQuotes == value.mAddQuotes &&
+                    mHasArrayIndex == value.mHasArrayIndex &&
+                    compareVectors(mArray, value.mArray));
+            }
+
+            bool compareVectors(const havINIDataVector& vector1, const havINIDataVector& vector2) const
+            {
+                return vector1.size() == vector2.size() && std::equal(vector1.begin(), vector1.end(), vector2.begin());
+            }
+
+            void operator=(const char* value)
+            {
+                SetValue(value);
+            }
+
+            void operator=(std::string_view value)
+            {
+                SetValue(value);
+            }
+
+            havINIData& operator[](int index)
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Property is not an array!");
+                }
+
+                if (index < 0 || static_cast<std::size_t>(index) >= mArray.size())
+                {
+                    throw std::out_of_range("Index is out of range!");
+                }
+
+                return mArray[index];
+            }
+
+            havINIData& operator[](char key)
+            {
+                return operator[](std::string_view(&key, 1));
+            }
+
+            // The key is only copied, if a new array entry has to be added
+            havINIData& operator[](std::string_view key)
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Property is not an array!");
+                }
+
+                auto foundKeyValuePair = FindArrayEntry(key);
+
+                if (foundKeyValuePair == mArray.end())
+                {
+                    std::string newKey(key);
+
+                    CasePolicy::Fold(newKey);
+
+                    mArray.emplace_back(newKey, havINIDataType::Value);
+                    AddedArrayEntry(false);
+
+                    return mArray.back();
+                }
+
+                return *foundKeyValuePair;
+            }
+
+            std::vector<std::string> Split(const std::string& delimiter)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    throw std::runtime_error("Split is not supported by a property of type array!");
+                }
+
+                return havUtils::Split(mValue, delimiter);
+            }
+
+            void Join(const std::vector<std::string>& values, const std::string& delimiter)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    throw std::runtime_error("Join is not supported by a property of type array!");
+                }
+
+                std::string result = havUtils::Join(values, delimiter);
+
+                SetValue(result);
+            }
+
+            const havINIString& GetKey() const { return mKey; }
+            havINIDataType GetType() const { return mType; }
+            const havINIString& GetValue() const { return mValue; }
+            std::string GetInlineComment() const
+            {
+                if (HasInlineComment() == false)
+                {
+                    return "";
+                }
+                return std::string(mInlineComment.value());
+            }
+
+            void SetValue(std::string_view value)
+            {
+                mValue = value;
+                mCachedValue = std::monostate();
+                MarkModified();
+            }
+
+            // Returns the value converted with std::from_chars or the default value, if the value can not be converted or does not fit into T
+            // The parsed result is cached, so repeated reads don't parse the value again
+            template<typename T>
+            T GetValueAs(T defaultValue)
+            {
+                static_assert(std::is_arithmetic_v<T> == true && std::is_same_v<T, long double> == false, "GetValueAs only supports bool, integer, float and double values!");
+
+                if (mType == havINIDataType::Array)
+                {
+                    throw std::runtime_error("GetValueAs is not supported by a property of type array!");
+                }
+
+                using ParsedType = typename havUtils::FromCharsType<T>::type;
+
+                const ParsedType* parsedValue = std::get_if<ParsedType>(&mCachedValue);
+
+                if (parsedValue == nullptr)
+                {
+                    ParsedType newParsedValue;
+
+                    if (havUtils::FromChars(mValue, newParsedValue) == false)
+                    {
+                        return defaultValue;
+                    }
+
+                    parsedValue = &mCachedValue.template emplace<ParsedType>(newParsedValue);
+                }
+
+                // Like havUtils::ConvertValue, only the result of FromChars is cached
+                T value = defaultValue;
+                havUtils::ConvertParsedValue(*parsedValue, value);
+
+                return value;
+            }
+
+            template<typename T>
+            T GetArrayValueAs(std::string_view key, T defaultValue)
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Data is not of type array!");
+                }
+
+                auto foundKeyValuePair = FindArrayEntry(key);
+
+                if (foundKeyValuePair == mArray.end())
+                {
+                    return defaultValue;
+                }
+
+                return foundKeyValuePair->GetValueAs(defaultValue);
+            }
+
+            // Returns the values of all array entries converted with GetValueAs
+            template<typename T>
+            std::vector<T> GetArrayValuesAs(T defaultValue)
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Data is not of type array!");
+                }
+
+                std::vector<T> values;
+                values.reserve(mArray.size());
+
+                for (auto& arrayEntry : mArray)
+                {
+                    values.push_back(arrayEntry.GetValueAs(defaultValue));
+                }
+
+                return values;
+            }
+
+            void SetArrayEntry(std::string key, std::string_view value, bool addQuotes, bool setInlineComment, std::string_view inlineComment = {})
+            {
+                bool generatedKey = key.empty();
+
+                if (generatedKey == true)
+                {
+                    key = std::to_string(GetArrayIndex());
+                }
+
+                CasePolicy::Fold(key);
+
+                // A generated key is always larger than any existing one, so there is nothing to look up
+                auto foundKeyValuePair = (generatedKey == true) ? mArray.end() : FindArrayEntry(key);
+
+                if (foundKeyValuePair == mArray.end())
+                {
+                    mArray.emplace_back(key, value, havINIDataType::Value);
+                    AddedArrayEntry(generatedKey);
+
+                    mArray.back().SetAddQuotes(addQuotes);
+
+                    if (setInlineComment == true)
+                    {
+                        mArray.back().SetInlineComment(inlineComment);
+                    }
+                }
+                else
+                {
+                    foundKeyValuePair->SetValue(value);
+                    foundKeyValuePair->SetInlineComment(inlineComment);
+                    foundKeyValuePair->SetAddQuotes(addQuotes);
+                }
+            }
+
+            void ArrayClear()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    mArray.clear();
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            bool ArrayEmpty()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.empty();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayErase(typename havINIDataVector::iterator itr)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    mArray.erase(itr);
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            typename havINIDataVector::const_iterator ArrayCBegin() const
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.cbegin();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            typename havINIDataVector::const_iterator ArrayCEnd() const
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.cend();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            typename havINIDataVector::iterator ArrayBegin()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.begin();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            typename havINIDataVector::iterator ArrayEnd()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.end();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            havINIData& ArrayFront()
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Data is not of type array!");
+                }
+
+                if (mArray.empty() == true)
+                {
+                    throw std::out_of_range("Array is empty!");
+                }
+
+                return mArray.front();
+            }
+
+            havINIData& ArrayBack()
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Data is not of type array!");
+                }
+
+                if (mArray.empty() == true)
+                {
+                    throw std::out_of_range("Array is empty!");
+                }
+
+                return mArray.back();
+            }
+
+            void ArrayInsert(unsigned int index, const havINIData& newValue)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    auto itr = mArray.begin();
+
+                    mArray.insert(itr + index, newValue);
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayPushBack(const havINIData& newValue)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    mArray.push_back(newValue);
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayPushFront(const havINIData& newValue)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    auto itr = mArray.begin();
+
+                    mArray.insert(itr, newValue);
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayPopBack()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    if (mArray.empty() == false)
+                    {
+                        mArray.pop_back();
+                        InvalidateArrayIndex();
+                    }
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayPopFront()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    if (mArray.empty() == false)
+                    {
+                        auto itr = mArray.begin();
+
+                        mArray.erase(itr);
+                        InvalidateArrayIndex();
+                    }
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayRemove(unsigned int index)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    if (mArray.empty() == false)
+                    {
+                        auto itr = mArray.begin();
+
+                        mArray.erase(itr + index);
+                        InvalidateArrayIndex();
+                    }
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            void ArrayRemove(std::string_view keyName)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    auto itr = FindArrayEntry(keyName);
+
+                    if (itr == mArray.end())
+                    {
+                        throw std::runtime_error("Provided key could not be found in array!");
+                    }
+
+                    mArray.erase(itr);
+                    InvalidateArrayIndex();
+
+                    return;
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            bool ArrayContains(const havINIData& value)
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return std::find(mArray.begin(), mArray.end(), value) != mArray.end();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            havINIData& ArrayAt(unsigned int index)
+            {
+                if (mType != havINIDataType::Array)
+                {
+                    throw std::runtime_error("Data is not of type array!");
+                }
+
+                return mArray.at(index);
+            }
+
+            typename havINIDataVector::size_type ArraySize()
+            {
+                if (mType == havINIDataType::Array)
+                {
+                    return mArray.size();
+                }
+
+                throw std::runtime_error("Data is not of type array!");
+            }
+
+            bool HasInlineComment() const { return mInlineComment.has_value(); }
+            void SetInlineComment(std::string_view inlineComment)
+            {
+                MarkModified();
+
+                if (inlineComment.empty() == true)
+                {
+                    mInlineComment = std::nullopt;
+
+                    return;
+                }
+
+                // The comment is kept in the memory of the entry
+                mInlineComment.emplace(inlineComment, mKey.get_allocator());
+            }
+
+            bool GetAddQuotes() const { return mAddQuotes; }
+            void SetAddQuotes(bool addQuotes) { mAddQuotes = addQuotes; MarkModified(); }
+
+            unsigned int GetArrayIndex()
+            {
+                // The next free index only needs to be recalculated after the array has been modified
+                if (mHasValidArrayIndex == true)
+                {
+                    return mArrayIndex;
+                }
+
+                unsigned int arrayIndex = 0;
+
+                for (const auto& arrayEntry : mArray)
+                {
+                    unsigned int arrayKey = std::stol(std::string(arrayEntry.GetKey()));
+
+                    if (arrayIndex <= arrayKey)
+                    {
+                        arrayIndex = arrayKey + 1;
+                    }
+                }
+
+                mArrayIndex = arrayIndex;
+                mHasValidArrayIndex = true;
+
+                return mArrayIndex;
+            }
+
+            void SetHasArrayIndex(bool hasArrayIndex) { mHasArrayIndex = hasArrayIndex; MarkModified(); }
+            bool HasArrayIndex() const { return mHasArrayIndex; }
+
+            // Changed since the last incremental write, including the entries of an array (see basic_havINIStream::SetIncrementalWrite)
+            bool IsModified() const
+            {
+                return mIsModified == true || (mType == havINIDataType::Array && std::any_of(mArray.begin(), mArray.end(), [](const havINIData& arrayEntry) { return arrayEntry.IsModified(); }));
+            }
+
+        private:
+            void SetKey(std::string key)
+            {
+                CasePolicy::Fold(key);
+
+                mKey = key;
+                MarkModified();
+            }
+
+            typename havINIDataVector::iterator FindArrayEntry(std::string_view key)
+            {
+                std::size_t slot = mArrayKeyIndex.Find(key, mArray, [](const havINIData& data) -> std::string_view { return data.GetKey(); } );
+
+                if (slot == havINIHashIndex<CasePolicy, Allocator>::npos)
+                {
+                    return mArray.end();
+                }
+
+                return mArray.begin() + slot;
+            }
+
+            // Must be called after an entry has been appended to the end of the array
+            void AddedArrayEntry(bool generatedKey)
+            {
+                mArrayKeyIndex.Insert(mArray.back().GetKey(), mArray.size() - 1);
+                MarkModified();
+
+                // Appending the generated key moves the next free index by one, any other key may be a larger index
+                if (generatedKey == true && mHasValidArrayIndex == true)
+                {
+                    ++mArrayIndex;
+                }
+                else
+                {
+                    mHasValidArrayIndex = false;
+                }
+            }
+
+            // Must be called whenever entries are inserted before the end or removed
+            void InvalidateArrayIndex()
+            {
+                mArrayKeyIndex.Invalidate();
+                mHasValidArrayIndex = false;
+                MarkModified();
+            }
+
+            void MarkModified()
+            {
+                mIsModified = true;
+                mIsChangedSinceParse = true;
+            }
+
+            void ClearModified()
+            {
+                mIsModified = false;
+
+                for (havINIData& arrayEntry : mArray)
+                {
+                    arrayEntry.mIsModified = false;
+                }
+            }
+
+            bool IsChangedSinceParse() const
+            {
+                return mIsChangedSinceParse == true || (mType == havINIDataType::Array && std::any_of(mArray.begin(), mArray.end(), [](const havINIData& arrayEntry) { return arrayEntry.mIsChangedSinceParse; }));
+            }
+
+            void ClearChangedSinceParse()
+            {
+                mIsChangedSinceParse = false;
+
+                for (havINIData& arrayEntry : mArray)
+                {
+                    arrayEntry.mIsChangedSinceParse = false;
+                }
+            }
+
+            friend class basic_havINISection<CasePolicy, Allocator>;
+
+            havINIDataType mType;
+            havINIString mKey;
+            havINIString mValue;
+            std::optional<havINIString> mInlineComment;
+            bool mAddQuotes;
+
+            unsigned int mArrayIndex; // Next free array index, only valid if mHasValidArrayIndex is true
+            bool mHasValidArrayIndex = false;
+            bool mHasArrayIndex;
+            havINIDataVector mArray;
+            havINIHashIndex<CasePolicy, Allocator> mArrayKeyIndex; // Array key -> slot in mArray
+
+            std::variant<std::monostate, bool, long long, unsigned long long, double> mCachedValue; // Last result of GetValueAs, reset whenever the value changes
+
+            // Set by every change, so a reference which is still held after an incremental write is written again. Cleared with the section.
+            bool mIsModified = true;
+
+            // Set by every change like mIsModified, but only cleared when the contents were parsed, so ReloadFile doesn't take over edited sections
+            bool mIsChangedSinceParse = true;
+    };
+
+    template<class CasePolicy, class Allocator>
+    class basic_havINISection
+    {
+    public:
+        using havINIData = basic_havINIData<CasePolicy, Allocator>;
+        using havINISection = basic_havINISection;
+        using allocator_type = Allocator;
+        using havINIString = typename havINIData::havINIString;
+        using havINIDataVector = typename havINIData::havINIDataVector;
+
+        explicit basic_havINISection(
+        std::string_view sectionName, std::optional<std::string_view> inlineComment = std::nullopt, const havINIDataVector& keyValuePairs = {}) :
+        basic_havINISection(std::allocator_arg, Allocator(), sectionName, inlineComment, keyValuePairs)
+        {
+        }
+
+        basic_havINISection(
+        std::allocator_arg_t, const Allocator& allocator, std::string_view sectionName, std::optional<std::string_view> inlineComment = std::nullopt, const havINIDataVector& keyValuePairs = {}) :
+        mSectionName(sectionName, allocator), mKeyValuePairs(keyValuePairs, allocator), mKeyIndex(allocator), mTrivia(allocator), mTriviaAnchors(allocator), mTriviaIndex(allocator), mCommentLineCount(0), mEmptyLineCount(0), mIsModified(true), mIsChangedSinceParse(true), mWrittenContents(allocator)
+        {
+            if (inlineComment.has_value() == true)
+            {
+                mInlineComment.emplace(inlineComment.value(), allocator);
+            }
+        }
+
+        basic_havINISection(havINISection&& value) noexcept :
+        mSectionName(std::move(value.mSectionName)), mInlineComment(std::move(value.mInlineComment)), mKeyValuePairs(std::move(value.mKeyValuePairs)), mKeyIndex(std::move(value.mKeyIndex)),
+        mTrivia(std::move(value.mTrivia)), mTriviaAnchors(std::move(value.mTriviaAnchors)), mTriviaIndex(std::move(value.mTriviaIndex)), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount),
+        mIsModified(value.mIsModified), mIsChangedSinceParse(value.mIsChangedSinceParse), mWrittenContents(std::move(value.mWrittenContents))
+        {
+        }
+
+        basic_havINISection(const havINISection& value) :
+        mSectionName(value.mSectionName), mInlineComment(value.mInlineComment), mKeyValuePairs(value.mKeyValuePairs), mKeyIndex(value.mKeyIndex),
+        mTrivia(value.mTrivia), mTriviaAnchors(value.mTriviaAnchors), mTriviaIndex(value.mTriviaIndex), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount),
+        mIsModified(value.mIsModified), mIsChangedSinceParse(value.mIsChangedSinceParse), mWrittenContents(value.mWrittenContents)
+        {
+        }
+
+        // Used by the vector of sections to move or copy sections into its own memory
+        basic_havINISection(std::allocator_arg_t, const Allocator& allocator, havINISection&& value) :
+        mSectionName(std::move(value.mSectionName), allocator), mKeyValuePairs(std::move(value.mKeyValuePairs), allocator), mKeyIndex(std::move(value.mKeyIndex), allocator),
+        mTrivia(std::move(value.mTrivia), allocator), mTriviaAnchors(std::move(value.mTriviaAnchors), allocator), mTriviaIndex(std::move(value.mTriviaIndex), allocator), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount),
+        mIsModified(value.mIsModified), mIsChangedSinceParse(value.mIsChangedSinceParse), mWrittenContents(std::move(value.mWrittenContents), allocator)
+        {
+            if (value.mInlineComment.has_value() == true)
+            {
+                mInlineComment.emplace(std::move(value.mInlineComment.value()), allocator);
+            }
+        }
+
+        basic_havINISection(std::allocator_arg_t, const Allocator& allocator, const havINISection& value) :
+        mSectionName(value.mSectionName, allocator), mKeyValuePairs(value.mKeyValuePairs, allocator), mKeyIndex(value.mKeyIndex, allocator),
+        mTrivia(value.mTrivia, allocator), mTriviaAnchors(value.mTriviaAnchors, allocator), mTriviaIndex(value.mTriviaIndex, allocator), mCommentLineCount(value.mCommentLineCount), mEmptyLineCount(value.mEmptyLineCount),
+        mIsModified(value.mIsModified), mIsChangedSinceParse(value.mIsChangedSinceParse), mWrittenContents(value.mWrittenContents, allocator)
+        {
+            if (value.mInlineComment.has_value() == true)
+            {
+                mInlineComment.emplace(value.mInlineComment.value(), allocator);
+            }
+        }
+
+        havINISection& operator=(havINISection&& value) noexcept(std::allocator_traits<Allocator>::is_always_equal::value)
+        {
+            if (this != &value)
+            {
+                mSectionName = std::move(value.mSectionName);
+                mInlineComment = std::move(value.mInlineComment);
+                mKeyValuePairs = std::move(value.mKeyValuePairs);
+                mKeyIndex = std::move(value.mKeyIndex);
+                mTrivia = std::move(value.mTrivia);
+                mTriviaAnchors = std::move(value.mTriviaAnchors);
+                mTriviaIndex = std::move(value.mTriviaIndex);
+                mCommentLineCount = value.mCommentLineCount;
+                mEmptyLineCount = value.mEmptyLineCount;
+                mIsModified = value.mIsModified;
+                mIsChangedSinceParse = value.mIsChangedSinceParse;
+                mWrittenContents = std::move(value.mWrittenContents);
+            }
+
+            return *this;
+        }
+
+        havINISection& operator=(const havINISection& value)
+        {
+            if (this != &value)
+            {
+                mSectionName = value.mSectionName;
+                mInlineComment = value.mInlineComment;
+                mKeyValuePairs = value.mKeyValuePairs;
+                mKeyIndex = value.mKeyIndex;
+                mTrivia = value.mTrivia;
+                mTriviaAnchors = value.mTriviaAnchors;
+                mTriviaIndex = value.mTriviaIndex;
+                mCommentLineCount = value.mCommentLineCount;
+                mEmptyLineCount = value.mEmptyLineCount;
+                mIsModified = value.mIsModified;
+                mIsChangedSinceParse = value.mIsChangedSinceParse;
+                mWrittenContents = value.mWrittenContents;
+            }
+
+            return *this;
+        }
+
+        havINIData& operator[](int index)
+        {
+            if (index < 0 || static_cast<std::size_t>(index) >= mKeyValuePairs.size())
+            {
+                throw std::out_of_range("Index is out of range!");
+            }
+
+            return mKeyValuePairs[index];
+        }
+
+        havINIData& operator[](char key)
+        {
+            return operator[](std::string_view(&key, 1));
+        }
+
+        // The key is only copied, if a new key value pair has to be added
+        havINIData& operator[](std::string_view key)
+        {
+            auto foundKeyValuePair = FindKeyValuePair(key);
+
+            if (foundKeyValuePair == mKeyValuePairs.end())
+            {
+                std::string newKey(key);
+
+                CasePolicy::Fold(newKey);
+
+                mKeyValuePairs.emplace_back(newKey, havINIDataType::Value);
+                mKeyIndex.Insert(newKey, mKeyValuePairs.size() - 1);
+                foundKeyValuePair = std::prev(mKeyValuePairs.end());
+
+                MarkModified();
+            }
+
+            return *foundKeyValuePair;
+        }
+
+        void SetInlineComment(std::string_view inlineComment)
+        {
+            MarkModified();
+
+            if (inlineComment.empty() == true)
+            {
+                mInlineComment = std::nullopt;
+
+                return;
+            }
+
+            // The comment is kept in the memory of the section
+            mInlineComment.emplace(inlineComment, mSectionName.get_allocator());
+        }
+
+        bool SetEmptyLine(std::string key, const havINIPosition& position, std::optional<std::string> otherKeyName = std::nullopt)
+        {
+            return SetTrivia(std::move(key), "", havINIDataType::Empty, position, std::move(otherKeyName));
+        }
+
+        void SetKeyValuePair(std::string_view key, std::string_view value, bool addQuotes)
+        {
+            MarkModified();
+
+            auto foundKeyValuePair = FindKeyValuePair(key);
+
+            if (foundKeyValuePair != mKeyValuePairs.end())
+            {
+                foundKeyValuePair->SetValue(value);
+                foundKeyValuePair->SetAddQuotes(addQuotes);
+            }
+            else
+            {
+                std::string newKey(key);
+
+                CasePolicy::Fold(newKey);
+
+                mKeyValuePairs.emplace_back(newKey, value, havINIDataType::Value, addQuotes);
+                mKeyIndex.Insert(newKey, mKeyValuePairs.size() - 1);
+            }
+        }
+
+        void SetArrayEntry(std::string_view key, std::string_view value, bool addQuotes, bool setInlineComment, std::string_view inlineComment = {}, const std::string& arrayIndex = "", bool hasArrayIndex = false)
+        {
+            MarkModified();
+
+            auto foundKeyValuePair = FindKeyValuePair(key);
+
+            if (foundKeyValuePair != mKeyValuePairs.end())
+            {
+                if (hasArrayIndex == true)
+                {
+                    foundKeyValuePair->SetArrayEntry(arrayIndex, value, addQuotes, setInlineComment, inlineComment);
+                }
+                else
+                {
+                    foundKeyValuePair->SetArrayEntry("", value, addQuotes, setInlineComment, inlineComment);
+                }
+            }
+            else
+            {
+                std::string newKey(key);
+
+                CasePolicy::Fold(newKey);
+
+                mKeyValuePairs.emplace_back(newKey, havINIDataType::Array, false, hasArrayIndex);
+                mKeyIndex.Insert(newKey, mKeyValuePairs.size() - 1);
+
+                auto foundNewKeyValuePair = std::prev(mKeyValuePairs.end());
+
+                if (hasArrayIndex == true)
+                {
+                    foundNewKeyValuePair->SetArrayEntry(arrayIndex, value, addQuotes, setInlineComment, inlineComment);
+                }
+                else
+                {
+                    foundNewKeyValuePair->SetArrayEntry("", value, addQuotes, setInlineComment, inlineComment);
+                }
+            }
+        }
+
+        std::ptrdiff_t GetIndex(havINIData& data)
+        {
+            return std::distance(mKeyValuePairs.data(), std::addressof(data));
+        }
+
+        bool SetComment(std::string key, std::string_view value, const havINIPosition& position, std::optional<std::string> otherKeyName = std::nullopt)
+        {
+            return SetTrivia(std::move(key), value, havINIDataType::Comment, position, std::move(otherKeyName));
+        }
+
+        void SetKey(std::string key, typename havINIDataVector::iterator it)
+        {
+            CasePolicy::Fold(key);
+
+            it->SetKey(key);
+
+            mKeyIndex.Invalidate();
+            MarkModified();
+        }
+
+        // The stream which owns the section notices the rename and rebuilds its section index on the next lookup
+        void SetSectionName(std::string sectionName)
+        {
+            CasePolicy::Fold(sectionName);
+
+            mSectionName = sectionName;
+            MarkModified();
+
+            sRenameCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const havINIString& GetSectionName() const { return mSectionName; }
+        std::string GetInlineComment() const
+        {
+            if (HasInlineComment() == false)
+            {
+                return "";
+            }
+            return std::string(mInlineComment.value());
+        }
+        const havINIDataVector& GetKeyValuePairs() const { return mKeyValuePairs; } // Read-only, comments and empty lines are kept in GetTrivia
+        const havINIDataVector& GetTrivia() const { return mTrivia; } // Read-only, comments and empty lines in the order of the document
+
+        // Calls visitor(data) for every key value pair, array, comment and empty line in the order of the document
+        template<class Visitor>
+        void ForEachEntry(Visitor visitor) const
+        {
+            std::size_t trivia = 0;
+
+            for (std::size_t slot = 0; slot <= mKeyValuePairs.size(); ++slot)
+            {
+                for (; trivia < mTrivia.size() && mTriviaAnchors[trivia] == slot; ++trivia)
+                {
+                    visitor(mTrivia[trivia]);
+                }
+
+                if (slot < mKeyValuePairs.size())
+                {
+                    visitor(mKeyValuePairs[slot]);
+                }
+            }
+        }
+
+        // A change through the iterator marks the key value pair itself, so the section is written again by incremental writes
+        typename havINIDataVector::iterator GetKeyValuePair(std::string_view key)
+        {
+            return FindKeyValuePair(key);
+        }
+
+        bool HasInlineComment() const { return mInlineComment.has_value(); }
+
+        // Changed since the last incremental write (see basic_havINIStream::SetIncrementalWrite), the key value pairs keep their own flags
+        bool IsModified() const
+        {
+            return mIsModified == true || std::any_of(mKeyValuePairs.begin(), mKeyValuePairs.end(), [](const havINIData& keyValuePair) { return keyValuePair.IsModified(); });
+        }
+
+        bool HasKey(std::string_view keyName)
+        {
+            return FindKeyValuePair(keyName) != mKeyValuePairs.end();
+        }
+
+        // The view is only valid until the key value pair is changed or removed
+        std::string_view GetValueView(std::string_view keyName, std::string_view defaultValue = {})
+        {
+            auto foundKeyValuePair = FindKeyValuePair(keyName);
+
+            return (foundKeyValuePair == mKeyValuePairs.end()) ? defaultValue : std::string_view(foundKeyValuePair->GetValue());
+        }
+
+        // Stores the value of every key of keyNames at the same position in values, defaultValue if the key doesn't exist.
+        // Both ranges can e.g. be arrays or vectors of std::string_view. Returns the number of keys which were found.
+        template<class KeyRange, class ValueRange>
+        std::size_t GetValues(const KeyRange& keyNames, ValueRange&& values, std::string_view defaultValue = {})
+        {
+            if (std::size(values) < std::size(keyNames))
+            {
+                throw std::out_of_range("There must be a value for every key!");
+            }
+
+            std::size_t foundCount = 0;
+            auto value = std::begin(values);
+
+            for (const auto& keyName : keyNames)
+            {
+                auto foundKeyValuePair = FindKeyValuePair(keyName);
+
+                if (foundKeyValuePair != mKeyValuePairs.end())
+                {
+                    *value = foundKeyValuePair->GetValue();
+                    ++foundCount;
+                }
+                else
+                {
+                    *value = defaultValue;
+                }
+
+                ++value;
+            }
+
+            return foundCount;
+        }
+
+        typename havINIDataVector::size_type GetNumberOfKeys() const
+        {
+            return mKeyValuePairs.size();
+        }
+
+        void RemoveKeyValuePair(typename havINIDataVector::iterator it)
+        {
+            std::size_t slot = static_cast<std::size_t>(std::distance(mKeyValuePairs.begin(), it));
+
+            // Comments and empty lines behind the key value pair move up with the following key value pairs
+            for (std::size_t trivia = mTrivia.size(); trivia > 0 && mTriviaAnchors[trivia - 1] > slot; --trivia)
+            {
+                --mTriviaAnchors[trivia - 1];
+            }
+
+            mKeyValuePairs.erase(it);
+            mKeyIndex.Invalidate();
+            MarkModified();
+        }
+
+        bool RemoveKeyValuePair(std::string_view keyName)
+        {
+            auto foundKeyValuePair = FindKeyValuePair(keyName);
+
+            if (foundKeyValuePair != mKeyValuePairs.end())
+            {
+                RemoveKeyValuePair(foundKeyValuePair);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        unsigned int GetCommentLineCount() { return ++mCommentLineCount; }
+        unsigned int GetEmptyLineCount() { return ++mEmptyLineCount; }
+
+        std::vector<std::string> GetCommentKeyNames(std::string keyName)
+        {
+            CasePolicy::Fold(keyName);
+
+            std::vector<std::string> commentKeyNames;
+
+            for (const auto& keyValuePair : mTrivia)
+            {
+                const havINIString& key = keyValuePair.GetKey();
+
+                if (havUtils::StartsWith(key, keyName) == true && keyValuePair.GetType() == havINIDataType::Comment)
+                {
+                    commentKeyNames.emplace_back(key);
+                }
+            }
+
+            return commentKeyNames;
+        }
+
+        bool RemoveComment(std::string_view keyName)
+        {
+            return RemoveTrivia(keyName, havINIDataType::Comment);
+        }
+
+        std::vector<std::string> GetEmptyLineKeyNames(std::string keyName)
+        {
+            CasePolicy::Fold(keyName);
+
+            std::vector<std::string> emptyLineKeyNames;
+
+            for (const auto& keyValuePair : mTrivia)
+            {
+                const havINIString& key = keyValuePair.GetKey();
+
+                if (havUtils::StartsWith(key, keyName) == true && keyValuePair.GetType() == havINIDataType::Empty)
+                {
+                    emptyLineKeyNames.emplace_back(key);
+                }
+            }
+
+            return emptyLineKeyNames;
+        }
+
+        bool RemoveEmptyLine(std::string_view keyName)
+        {
+            return RemoveTrivia(keyName, havINIDataType::Empty);
+        }
+
+        void Clear()
+        {
+            mInlineComment.reset();
+            mKeyValuePairs.clear();
+            mKeyIndex.Invalidate();
+            mTrivia.clear();
+            mTriviaAnchors.clear();
+            mTriviaIndex.Invalidate();
+
+            mCommentLineCount = 0;
+            mEmptyLineCount = 0;
+            MarkModified();
+        }
+
+    private:
+        typename havINIDataVector::iterator FindKeyValuePair(std::string_view key)
+        {
+            std::size_t slot = mKeyIndex.Find(key, mKeyValuePairs, [](const havINIData& data) -> std::string_view { return data.GetKey(); } );
+
+            if (slot == havINIHashIndex<CasePolicy, Allocator>::npos)
+            {
+                return mKeyValuePairs.end();
+            }
+
+            return mKeyValuePairs.begin() + slot;
+        }
+
+        std::size_t FindTrivia(std::string_view key)
+        {
+            return mTriviaIndex.Find(key, mTrivia, [](const havINIData& data) -> std::string_view { return data.GetKey(); } );
+        }
+
+        // Comments and empty lines are kept apart from the key value pairs, so they don't slow down the lookups of keys. Each one is anchored
+        // in front of a slot in mKeyValuePairs, the anchors are sorted and trivia with the same anchor are kept in the order of the document.
+        bool SetTrivia(std::string key, std::string_view value, havINIDataType type, const havINIPosition& position, std::optional<std::string> otherKeyName)
+        {
+            CasePolicy::Fold(key);
+
+            if (otherKeyName.has_value() == true)
+            {
+                CasePolicy::Fold(otherKeyName.value());
+            }
+
+            if (FindKeyValuePair(key) != mKeyValuePairs.end() || FindTrivia(key) != havINIHashIndex<CasePolicy, Allocator>::npos)
+            {
+                return false;
+            }
+
+            std::size_t index = mTrivia.size();
+            std::size_t anchor = mKeyValuePairs.size();
+
+            if (position == havINIPosition::Start)
+            {
+                index = 0;
+                anchor = 0;
+            }
+            else if (position == havINIPosition::Above || position == havINIPosition::Below)
+            {
+                auto foundOtherKeyValuePair = FindKeyValuePair(otherKeyName.value());
+
+                if (foundOtherKeyValuePair != mKeyValuePairs.end())
+                {
+                    std::size_t slot = static_cast<std::size_t>(GetIndex(*foundOtherKeyValuePair));
+
+                    // Directly above the key value pair means behind the trivia which are already in front of it
+                    anchor = (position == havINIPosition::Above) ? slot : slot + 1;
+                    index = (position == havINIPosition::Above) ?
+                        static_cast<std::size_t>(std::upper_bound(mTriviaAnchors.begin(), mTriviaAnchors.end(), anchor) - mTriviaAnchors.begin()) :
+                        static_cast<std::size_t>(std::lower_bound(mTriviaAnchors.begin(), mTriviaAnchors.end(), anchor) - mTriviaAnchors.begin());
+                }
+                else
+                {
+                    std::size_t otherTrivia = FindTrivia(otherKeyName.value());
+
+                    if (otherTrivia == havINIHashIndex<CasePolicy, Allocator>::npos)
+                    {
+                        throw std::runtime_error("\"" + otherKeyName.value() + "\" could not be found!");
+                    }
+
+                    anchor = mTriviaAnchors[otherTrivia];
+                    index = (position == havINIPosition::Above) ? otherTrivia : otherTrivia + 1;
+                }
+            }
+
+            MarkModified();
+
+            mTrivia.emplace(mTrivia.begin() + index, key, value, type);
+            mTriviaAnchors.insert(mTriviaAnchors.begin() + index, anchor);
+
+            if (index == mTrivia.size() - 1)
+            {
+                mTriviaIndex.Insert(key, index);
+            }
+            else
+            {
+                mTriviaIndex.Invalidate();
+            }
+
+            return true;
+        }
+
+        bool RemoveTrivia(std::string_view keyName, havINIDataType type)
+        {
+            std::size_t trivia = FindTrivia(keyName);
+
+            if (trivia != havINIHashIndex<CasePolicy, Allocator>::npos && mTrivia[trivia].GetType() == type)
+            {
+                mTrivia.erase(mTrivia.begin() + trivia);
+                mTriviaAnchors.erase(mTriviaAnchors.begin() + trivia);
+                mTriviaIndex.Invalidate();
+                MarkModified();
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void MarkModified()
+        {
+            mIsModified = true;
+            mIsChangedSinceParse = true;
+        }
+
+        void ClearModified()
+        {
+            mIsModified = false;
+
+            for (havINIData& keyValuePair : mKeyValuePairs)
+            {
+                keyValuePair.ClearModified();
+            }
+        }
+
+        bool IsChangedSinceParse() const
+        {
+            auto isChanged = [](const havINIData& data) { return data.IsChangedSinceParse(); };
+
+            return mIsChangedSinceParse == true || std::any_of(mKeyValuePairs.begin(), mKeyValuePairs.end(), isChanged) || std::any_of(mTrivia.begin(), mTrivia.end(), isChanged);
+        }
+
+        void ClearChangedSinceParse()
+        {
+            mIsChangedSinceParse = false;
+
+            for (havINIData& keyValuePair : mKeyValuePairs)
+            {
+                keyValuePair.ClearChangedSinceParse();
+            }
+
+            for (havINIData& trivia : mTrivia)
+            {
+                trivia.ClearChangedSinceParse();
+            }
+        }
+
+        friend class basic_havINIStream<CasePolicy, Allocator>;
+
+        // Counts the renames of all sections, so a stream only needs to compare it with the count its section index was built for
+        inline static std::atomic<std::size_t> sRenameCount{ 0 };
+
+        havINIString mSectionName;
+        std::optional<havINIString> mInlineComment;
+        havINIDataVector mKeyValuePairs;
+        havINIHashIndex<CasePolicy, Allocator> mKeyIndex; // Key name -> slot in mKeyValuePairs
+
+        havINIDataVector mTrivia; // Comments and empty lines
+        std::vector<std::size_t, typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>> mTriviaAnchors; // Slot in mKeyValuePairs in front of which the trivia stands
+        havINIHashIndex<CasePolicy, Allocator> mTriviaIndex; // Key name -> slot in mTrivia
+
+        unsigned int mCommentLineCount;
+        unsigned int mEmptyLineCount;
+
+        bool mIsModified; // Set by every change of the section itself, cleared with the flags of the key value pairs when the section was written to mWrittenContents
+        bool mIsChangedSinceParse; // Like the flag of havINIData
+        havINIString mWrittenContents; // The section as it was written last, without the newline in front of it
+    };
+
+    // Read-only copy of a document, created with basic_havINIStream::Freeze. All names and values are stored in one string pool,
+    // sections, key value pairs and array entries in flat tables of offsets, comments and empty lines are left out.
+    // Lookups hash the section name and the key once and compare against the pool, so they only touch a few cache lines.
+    // All methods are const and the snapshot is never modified, so one snapshot can be read by any number of threads.
+    // The tables and the pool are kept in one binary image, which basic_havINIStream::SaveCompiled writes to a file and LoadCompiled maps
+    // back into memory. Copies of a snapshot share the image.
+    template<class CasePolicy>
+    class basic_havINISnapshot
+    {
+    public:
+        basic_havINISnapshot() = default;
+
+        // Sections is a vector of basic_havINISection, usually the sections of a stream
+        template<class SectionVector>
+        explicit basic_havINISnapshot(const SectionVector& sections)
+        {
+            std::size_t poolSize = 0;
+            std::size_t entryCount = 0;
+            std::size_t elementCount = 0;
+
+            for (const auto& section : sections)
+            {
+                poolSize += section.GetSectionName().size();
+
+                for (const auto& keyValuePair : section.GetKeyValuePairs())
+                {
+                    if (keyValuePair.GetType() == havINIDataType::Value)
+                    {
+                        poolSize += keyValuePair.GetKey().size() + keyValuePair.GetValue().size();
+                        ++entryCount;
+                    }
+                    else if (keyValuePair.GetType() == havINIDataType::Array)
+                    {
+                        poolSize += keyValuePair.GetKey().size();
+                        ++entryCount;
+
+                        for (auto arrayIterator = keyValuePair.ArrayCBegin(); arrayIterator != keyValuePair.ArrayCEnd(); ++arrayIterator)
+                        {
+                            poolSize += arrayIterator->GetKey().size() + arrayIterator->GetValue().size();
+                            ++elementCount;
+                        }
+                    }
+                }
+            }
+
+            CheckSize(poolSize, sections.size(), entryCount, elementCount);
+
+            havINISnapshotBuilder builder;
+
+            builder.pool.reserve(poolSize);
+            builder.sections.reserve(sections.size());
+            builder.entries.reserve(entryCount);
+            builder.elements.reserve(elementCount);
+
+            for (const auto& section : sections)
+            {
+                havINISnapshotSection newSection;
+                newSection.name = AddToPool(builder.pool, section.GetSectionName());
+                newSection.firstEntry = static_cast<std::uint32_t>(builder.entries.size());
+
+                for (const auto& keyValuePair : section.GetKeyValuePairs())
+                {
+                    if (keyValuePair.GetType() != havINIDataType::Value && keyValuePair.GetType() != havINIDataType::Array)
+                    {
+                        continue;
+                    }
+
+                    havINISnapshotEntry newEntry;
+                    newEntry.key = AddToPool(builder.pool, keyValuePair.GetKey());
+                    newEntry.hash = static_cast<std::uint32_t>(CasePolicy::Hash(keyValuePair.GetKey()));
+                    newEntry.isArray = (keyValuePair.GetType() == havINIDataType::Array);
+
+                    if (newEntry.isArray == true)
+                    {
+                        // The value of an array refers to its entries in mElements
+                        newEntry.value.offset = static_cast<std::uint32_t>(builder.elements.size());
+
+                        for (auto arrayIterator = keyValuePair.ArrayCBegin(); arrayIterator != keyValuePair.ArrayCEnd(); ++arrayIterator)
+                        {
+                            havINISnapshotString elementKey = AddToPool(builder.pool, arrayIterator->GetKey());
+
+                            builder.elements.push_back(havINISnapshotElement{ elementKey, AddToPool(builder.pool, arrayIterator->GetValue()) });
+                        }
+
+                        newEntry.value.size = static_cast<std::uint32_t>(builder.elements.size()) - newEntry.value.offset;
+                    }
+                    else
+                    {
+                        newEntry.value = AddToPool(builder.pool, keyValuePair.GetValue());
+                    }
+
+                    builder.entries.push_back(newEntry);
+                }
+
+                newSection.entryCount = static_cast<std::uint32_t>(builder.entries.size()) - newSection.firstEntry;
+                builder.sections.push_back(newSection);
+            }
+
+            BuildBuckets(builder);
+            SetImage(builder);
+        }
+
+        bool HasSection(std::string_view sectionName) const
+        {
+            return FindSection(sectionName) != npos;
+        }
+
+        bool HasKey(std::string_view sectionName, std::string_view keyName) const
+        {
+            return FindEntry(sectionName, keyName) != nullptr;
+        }
+
+        std::size_t GetNumberOfSections() const
+        {
+            return mSections.size();
+        }
+
+        // Comments and empty lines are not counted
+        std::size_t GetNumberOfKeys(std::string_view sectionName) const
+        {
+            std::uint32_t sectionIndex = FindSection(sectionName);
+
+            return (sectionIndex == npos) ? 0 : mSections[sectionIndex].entryCount;
+        }
+
+        std::vector<std::string_view> GetSectionNames() const
+        {
+            std::vector<std::string_view> sectionNames;
+            sectionNames.reserve(mSections.size());
+
+            for (const havINISnapshotSection& section : mSections)
+            {
+                sectionNames.push_back(View(section.name));
+            }
+
+            return sectionNames;
+        }
+
+        std::vector<std::string_view> GetKeyNames(std::string_view sectionName) const
+        {
+            std::vector<std::string_view> keyNames;
+
+            std::uint32_t sectionIndex = FindSection(sectionName);
+
+            if (sectionIndex != npos)
+            {
+                const havINISnapshotSection& section = mSections[sectionIndex];
+
+                keyNames.reserve(section.entryCount);
+
+                for (std::uint32_t entryIndex = section.firstEntry; entryIndex < section.firstEntry + section.entryCount; ++entryIndex)
+                {
+                    keyNames.push_back(View(mEntries[entryIndex].key));
+                }
+            }
+
+            return keyNames;
+        }
+
+        // The view stays valid as long as the snapshot exists
+        std::string_view GetValue(std::string_view sectionName, std::string_view keyName, std::string_view defaultValue = {}) const
+        {
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            if (entry == nullptr || entry->isArray == true)
+            {
+                return defaultValue;
+            }
+
+            return View(entry->value);
+        }
+
+        // Like GetValue for many keys of one section, the section is only searched once. Both ranges can e.g. be arrays or vectors of
+        // std::string_view, the value of every key is stored at the same position in values. Returns the number of keys which were found.
+        template<class KeyRange, class ValueRange>
+        std::size_t GetValues(std::string_view sectionName, const KeyRange& keyNames, ValueRange&& values, std::string_view defaultValue = {}) const
+        {
+            if (std::size(values) < std::size(keyNames))
+            {
+                throw std::out_of_range("There must be a value for every key!");
+            }
+
+            std::uint32_t sectionIndex = FindSection(sectionName);
+            std::size_t foundCount = 0;
+            auto value = std::begin(values);
+
+            for (const auto& keyName : keyNames)
+            {
+                const havINISnapshotEntry* entry = (sectionIndex == npos) ? nullptr : FindEntry(mSections[sectionIndex], keyName);
+
+                if (entry != nullptr && entry->isArray == false)
+                {
+                    *value = View(entry->value);
+                    ++foundCount;
+                }
+                else
+                {
+                    *value = defaultValue;
+                }
+
+                ++value;
+            }
+
+            return foundCount;
+        }
+
+        template<typename T>
+        T GetValueAs(std::string_view sectionName, std::string_view keyName, T defaultValue) const
+        {
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            if (entry == nullptr || entry->isArray == true)
+            {
+                return defaultValue;
+            }
+
+            return ConvertValue(View(entry->value), defaultValue);
+        }
+
+        std::size_t GetArraySize(std::string_view sectionName, std::string_view keyName) const
+        {
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            return (entry == nullptr || entry->isArray == false) ? 0 : entry->value.size;
+        }
+
+        std::string_view GetArrayValue(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey, std::string_view defaultValue = {}) const
+        {
+            const havINISnapshotElement* element = FindElement(sectionName, keyName, arrayKey);
+
+            return (element == nullptr) ? defaultValue : View(element->value);
+        }
+
+        template<typename T>
+        T GetArrayValueAs(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey, T defaultValue) const
+        {
+            const havINISnapshotElement* element = FindElement(sectionName, keyName, arrayKey);
+
+            return (element == nullptr) ? defaultValue : ConvertValue(View(element->value), defaultValue);
+        }
+
+        std::vector<std::string_view> GetArrayValues(std::string_view sectionName, std::string_view keyName) const
+        {
+            std::vector<std::string_view> values;
+
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            if (entry != nullptr && entry->isArray == true)
+            {
+                values.reserve(entry->value.size);
+
+                for (std::uint32_t elementIndex = entry->value.offset; elementIndex < entry->value.offset + entry->value.size; ++elementIndex)
+                {
+                    values.push_back(View(mElements[elementIndex].value));
+                }
+            }
+
+            return values;
+        }
+
+        template<typename T>
+        std::vector<T> GetArrayValuesAs(std::string_view sectionName, std::string_view keyName, T defaultValue) const
+        {
+            std::vector<T> values;
+
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            if (entry != nullptr && entry->isArray == true)
+            {
+                values.reserve(entry->value.size);
+
+                for (std::uint32_t elementIndex = entry->value.offset; elementIndex < entry->value.offset + entry->value.size; ++elementIndex)
+                {
+                    values.push_back(ConvertValue(View(mElements[elementIndex].value), defaultValue));
+                }
+            }
+
+            return values;
+        }
+
+    private:
+        static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+        struct havINISnapshotString
+        {
+            std::uint32_t offset = 0;
+            std::uint32_t size = 0;
+        };
+
+        struct havINISnapshotSection
+        {
+            havINISnapshotString name;
+            std::uint32_t firstEntry = 0;
+            std::uint32_t entryCount = 0;
+            std::uint32_t firstBucket = 0;
+            std::uint32_t bucketCount = 0; // Zero if the entries are searched linearly
+        };
+
+        struct havINISnapshotEntry
+        {
+            havINISnapshotString key;
+            havINISnapshotString value; // Offset and number of entries in mElements for arrays
+            std::uint32_t hash = 0;
+            bool isArray = false;
+            std::uint8_t padding[3] = {}; // Keeps the bytes of the image defined
+        };
+
+        struct havINISnapshotElement
+        {
+            havINISnapshotString key;
+            havINISnapshotString value;
+        };
+
+        struct havINISnapshotBucket
+        {
+            std::uint32_t hash;
+            std::uint32_t index; // Index + 1, zero marks an empty bucket
+        };
+
+        // The image starts with the header, followed by the sections, entries, elements, section buckets, entry buckets and the pool
+        struct havINISnapshotHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t byteOrder; // imageByteOrder in the byte order of the writer
+            std::uint32_t policyHash; // Hash of policyHashName, the stored hashes are only valid for the same case policy
+            std::uint32_t sectionCount;
+            std::uint32_t entryCount;
+            std::uint32_t elementCount;
+            std::uint32_t sectionBucketCount;
+            std::uint32_t entryBucketCount;
+            std::uint32_t poolSize;
+            std::uint32_t reserved;
+            std::uint64_t sourceHash; // Hash of the INI file the image was compiled from, zero if unknown
+            std::uint64_t checksum; // Hash of everything behind the header, zero if the image was not written to a file
+        };
+
+        static_assert(sizeof(havINISnapshotHeader) == 64 && sizeof(havINISnapshotEntry) == 24, "The snapshot image must not contain padding!");
+
+        static constexpr char imageMagic[8] = { 'h', 'a', 'v', 'I', 'N', 'I', 'S', '\0' };
+        static constexpr std::uint32_t imageVersion = 2; // 2: HashBytes mixes in the size at the end
+        static constexpr std::uint32_t imageByteOrder = 0x01020304;
+        static constexpr std::string_view policyHashName = "havINI Snapshot";
+
+        // Read-only view of a table in the image
+        template<typename T>
+        struct havINISnapshotTable
+        {
+            const T* values = nullptr;
+            std::size_t count = 0;
+
+            const T& operator[](std::size_t index) const { return values[index]; }
+            const T* data() const { return values; }
+            const T* begin() const { return values; }
+            const T* end() const { return values + count; }
+            std::size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+        };
+
+        // Tables of a snapshot while it is created, they are copied into the image afterwards
+        struct havINISnapshotBuilder
+        {
+            std::string pool;
+            std::vector<havINISnapshotSection> sections;
+            std::vector<havINISnapshotEntry> entries;
+            std::vector<havINISnapshotElement> elements;
+            std::vector<havINISnapshotBucket> sectionBuckets;
+            std::vector<havINISnapshotBucket> entryBuckets;
+        };
+
+        template<typename T>
+        static T ConvertValue(std::string_view value, T defaultValue)
+        {
+            static_assert(std::is_arithmetic_v<T> == true && std::is_same_v<T, long double> == false, "GetValueAs only supports bool, integer, float and double values!");
+
+            T result = defaultValue;
+            havUtils::ConvertValue(value, result);
+
+            return result;
+        }
+
+        // Offsets are stored as 32 bit values and the bucket tables have twice as many buckets as entries
+        static void CheckSize(std::size_t poolSize, std::size_t sectionCount, std::size_t entryCount, std::size_t elementCount)
+        {
+            constexpr std::size_t maxCount = std::numeric_limits<std::uint32_t>::max() / 4;
+
+            if (poolSize > std::numeric_limits<std::uint32_t>::max() || sectionCount > maxCount || entryCount > maxCount || elementCount > maxCount)
+            {
+                throw std::length_error("INI data is too large for a snapshot!");
+            }
+        }
+
+        static havINISnapshotString AddToPool(std::string& pool, std::string_view value)
+        {
+            havINISnapshotString poolString{ static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(value.size()) };
+
+            pool.append(value.data(), value.size());
+
+            return poolString;
+        }
+
+        std::string_view View(havINISnapshotString poolString) const
+        {
+            return std::string_view(mPool.data() + poolString.offset, poolString.size);
+        }
+
+        static std::uint32_t GetBucketCount(std::size_t count)
+        {
+            std::uint32_t bucketCount = 16;
+
+            while (bucketCount < count * 2)
+            {
+                bucketCount *= 2;
+            }
+
+            return bucketCount;
+        }
+
+        static void AddBucket(havINISnapshotBucket* buckets, std::uint32_t bucketCount, std::uint32_t hash, std::uint32_t index)
+        {
+            std::uint32_t mask = bucketCount - 1;
+            std::uint32_t bucket = hash & mask;
+
+            while (buckets[bucket].index != 0)
+            {
+                bucket = (bucket + 1) & mask;
+            }
+
+            buckets[bucket] = havINISnapshotBucket{ hash, index + 1 };
+        }
+
+        // Every section with enough keys gets its own range of buckets in mEntryBuckets,
+        // so a lookup only touches the memory of one section
+        static void BuildBuckets(havINISnapshotBuilder& builder)
+        {
+            builder.sectionBuckets.assign(GetBucketCount(builder.sections.size()), havINISnapshotBucket{ 0, 0 });
+
+            for (std::uint32_t sectionIndex = 0; sectionIndex < builder.sections.size(); ++sectionIndex)
+            {
+                AddBucket(builder.sectionBuckets.data(), static_cast<std::uint32_t>(builder.sectionBuckets.size()), static_cast<std::uint32_t>(CasePolicy::Hash(std::string_view(builder.pool.data() + builder.sections[sectionIndex].name.offset, builder.sections[sectionIndex].name.size))), sectionIndex);
+            }
+
+            std::size_t entryBucketCount = 0;
+
+            for (havINISnapshotSection& section : builder.sections)
+            {
+                if (section.entryCount >= HAVINI_HASH_INDEX_THRESHOLD)
+                {
+                    section.firstBucket = static_cast<std::uint32_t>(entryBucketCount);
+                    section.bucketCount = GetBucketCount(section.entryCount);
+
+                    entryBucketCount += section.bucketCount;
+                }
+            }
+
+            if (entryBucketCount > std::numeric_limits<std::uint32_t>::max())
+            {
+                throw std::length_error("INI data is too large for a snapshot!");
+            }
+
+            builder.entryBuckets.assign(entryBucketCount, havINISnapshotBucket{ 0, 0 });
+
+            for (const havINISnapshotSection& section : builder.sections)
+            {
+                if (section.bucketCount != 0)
+                {
+                    for (std::uint32_t entryIndex = section.firstEntry; entryIndex < section.firstEntry + section.entryCount; ++entryIndex)
+                    {
+                        AddBucket(builder.entryBuckets.data() + section.firstBucket, section.bucketCount, builder.entries[entryIndex].hash, entryIndex);
+                    }
+                }
+            }
+        }
+
+        template<typename T>
+        static void AppendTable(std::string& image, const std::vector<T>& table)
+        {
+            image.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+        }
+
+        // Copies the tables of the builder into a new image
+        void SetImage(const havINISnapshotBuilder& builder)
+        {
+            havINISnapshotHeader header{};
+            std::memcpy(header.magic, imageMagic, sizeof(imageMagic));
+            header.version = imageVersion;
+            header.byteOrder = imageByteOrder;
+            header.policyHash = static_cast<std::uint32_t>(CasePolicy::Hash(policyHashName));
+            header.sectionCount = static_cast<std::uint32_t>(builder.sections.size());
+            header.entryCount = static_cast<std::uint32_t>(builder.entries.size());
+            header.elementCount = static_cast<std::uint32_t>(builder.elements.size());
+            header.sectionBucketCount = static_cast<std::uint32_t>(builder.sectionBuckets.size());
+            header.entryBucketCount = static_cast<std::uint32_t>(builder.entryBuckets.size());
+            header.poolSize = static_cast<std::uint32_t>(builder.pool.size());
+
+            std::string image(sizeof(header), '\0');
+            image.reserve(static_cast<std::size_t>(GetImageSize(header)));
+
+            AppendTable(image, builder.sections);
+            AppendTable(image, builder.entries);
+            AppendTable(image, builder.elements);
+            AppendTable(image, builder.sectionBuckets);
+            AppendTable(image, builder.entryBuckets);
+            image += builder.pool;
+
+            // The checksum and the source hash are only set in the header of the file written by basic_havINIStream::SaveCompiled
+            std::memcpy(&image[0], &header, sizeof(header));
+
+            auto imageBuffer = std::make_shared<std::string>(std::move(image));
+
+            MapImage(std::shared_ptr<const char>(imageBuffer, imageBuffer->data()), header);
+        }
+
+        // Computed with 64 bits, so the counts of a damaged header can't overflow the size
+        static std::uint64_t GetImageSize(const havINISnapshotHeader& header)
+        {
+            return sizeof(havINISnapshotHeader) + static_cast<std::uint64_t>(header.sectionCount) * sizeof(havINISnapshotSection) + static_cast<std::uint64_t>(header.entryCount) * sizeof(havINISnapshotEntry) +
+                static_cast<std::uint64_t>(header.elementCount) * sizeof(havINISnapshotElement) + (static_cast<std::uint64_t>(header.sectionBucketCount) + header.entryBucketCount) * sizeof(havINISnapshotBucket) + header.poolSize;
+        }
+
+        // Uses the image in place, e.g. a file mapped into memory. False is returned without changing the snapshot, if the image is damaged or inconsistent,
+        // was written by another version or for another case policy or byte order, or if sourceHash isn't zero and doesn't match the image.
+        bool SetImage(std::shared_ptr<const char> image, std::size_t imageSize, std::uint64_t sourceHash)
+        {
+            havINISnapshotHeader header;
+
+            // The tables are read in place, so the image must be aligned like them
+            if (imageSize < sizeof(header) || reinterpret_cast<std::uintptr_t>(image.get()) % alignof(havINISnapshotHeader) != 0)
+            {
+                return false;
+            }
+
+            std::memcpy(&header, image.get(), sizeof(header));
+
+            if (std::memcmp(header.magic, imageMagic, sizeof(imageMagic)) != 0 || header.version != imageVersion || header.byteOrder != imageByteOrder ||
+                header.policyHash != static_cast<std::uint32_t>(CasePolicy::Hash(policyHashName)) || GetImageSize(header) != imageSize ||
+                (sourceHash != 0 && header.sourceHash != sourceHash) ||
+                header.checksum != havUtils::HashBytes(std::string_view(image.get() + sizeof(header), imageSize - sizeof(header))))
+            {
+                return false;
+            }
+
+            basic_havINISnapshot snapshot;
+            snapshot.MapImage(std::move(image), header);
+
+            // The checksum only detects accidental damage, the lookups must not leave the tables for any image
+            if (snapshot.IsImageConsistent() == false)
+            {
+                return false;
+            }
+
+            *this = std::move(snapshot);
+
+            return true;
+        }
+
+        void MapImage(std::shared_ptr<const char> image, const havINISnapshotHeader& header)
+        {
+            const char* tables = image.get() + sizeof(header);
+
+            mSections = MapTable<havINISnapshotSection>(tables, header.sectionCount);
+            mEntries = MapTable<havINISnapshotEntry>(tables, header.entryCount);
+            mElements = MapTable<havINISnapshotElement>(tables, header.elementCount);
+            mSectionBuckets = MapTable<havINISnapshotBucket>(tables, header.sectionBucketCount);
+            mEntryBuckets = MapTable<havINISnapshotBucket>(tables, header.entryBucketCount);
+            mPool = std::string_view(tables, header.poolSize);
+            mImageSize = static_cast<std::size_t>(GetImageSize(header));
+            mImage = std::move(image);
+        }
+
+        bool IsInPool(havINISnapshotString poolString) const
+        {
+            return poolString.offset <= mPool.size() && poolString.size <= mPool.size() - poolString.offset;
+        }
+
+        template<typename T>
+        static bool IsInTable(std::uint32_t first, std::uint32_t count, const havINISnapshotTable<T>& table)
+        {
+            return first <= table.size() && count <= table.size() - first;
+        }
+
+        // A lookup probes until it finds an empty bucket, so a range of buckets needs a size which is a power of two and at least one empty bucket.
+        // The indices of the buckets must lie in [firstIndex, firstIndex + indexCount).
+        static bool AreBucketsConsistent(const havINISnapshotBucket* buckets, std::uint32_t bucketCount, std::uint32_t firstIndex, std::uint32_t indexCount)
+        {
+            if ((bucketCount & (bucketCount - 1)) != 0)
+            {
+                return false;
+            }
+
+            bool hasEmptyBucket = false;
+
+            for (std::uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+            {
+                if (buckets[bucket].index == 0)
+                {
+                    hasEmptyBucket = true;
+                }
+                else if (buckets[bucket].index - 1 < firstIndex || buckets[bucket].index - 1 - firstIndex >= indexCount)
+                {
+                    return false;
+                }
+            }
+
+            return hasEmptyBucket == true || bucketCount == 0;
+        }
+
+        // Checks every offset, size and index of the mapped tables, so no lookup of the snapshot reads outside of the image or probes endlessly
+        bool IsImageConsistent() const
+        {
+            if (AreBucketsConsistent(mSectionBuckets.data(), static_cast<std::uint32_t>(mSectionBuckets.size()), 0, static_cast<std::uint32_t>(mSections.size())) == false)
+            {
+                return false;
+            }
+
+            for (const havINISnapshotSection& section : mSections)
+            {
+                if (IsInPool(section.name) == false || IsInTable(section.firstEntry, section.entryCount, mEntries) == false)
+                {
+                    return false;
+                }
+
+                if (section.bucketCount != 0 && (IsInTable(section.firstBucket, section.bucketCount, mEntryBuckets) == false ||
+                    AreBucketsConsistent(mEntryBuckets.data() + section.firstBucket, section.bucketCount, section.firstEntry, section.entryCount) == false))
+                {
+                    return false;
+                }
+            }
+
+            for (const havINISnapshotEntry& entry : mEntries)
+            {
+                std::uint8_t isArray;
+
+                // The byte is read as is, because a bool with another value than 0 or 1 is undefined behavior
+                std::memcpy(&isArray, &entry.isArray, sizeof(isArray));
+
+                if (isArray > 1 || IsInPool(entry.key) == false ||
+                    ((isArray == 1) ? IsInTable(entry.value.offset, entry.value.size, mElements) : IsInPool(entry.value)) == false)
+                {
+                    return false;
+                }
+            }
+
+            for (const havINISnapshotElement& element : mElements)
+            {
+                if (IsInPool(element.key) == false || IsInPool(element.value) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Resolves the layers into one snapshot, a key of a later layer replaces the key of the earlier layers. Sections and keys keep the order
+        // in which they appear first. entryLayers receives the layer which supplied each entry of the result.
+        static basic_havINISnapshot Merge(const std::vector<basic_havINISnapshot>& layers, std::vector<std::uint32_t>& entryLayers)
+        {
+            struct havINIMergedEntry
+            {
+                std::string_view key;
+                std::uint32_t layer;
+                const havINISnapshotEntry* entry;
+            };
+
+            struct havINIMergedSection
+            {
+                std::string_view name;
+                std::vector<havINIMergedEntry> entries;
+                havINIHashIndex<CasePolicy> keyIndex; // Key -> slot in entries
+            };
+
+            std::vector<havINIMergedSection> mergedSections;
+            havINIHashIndex<CasePolicy> sectionIndex; // Section name -> slot in mergedSections
+
+            for (std::uint32_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
+            {
+                const basic_havINISnapshot& layer = layers[layerIndex];
+
+                for (const havINISnapshotSection& section : layer.mSections)
+                {
+                    std::string_view sectionName = layer.View(section.name);
+                    std::size_t sectionSlot = sectionIndex.Find(sectionName, mergedSections, [](const havINIMergedSection& merged) -> std::string_view { return merged.name; });
+
+                    if (sectionSlot == havINIHashIndex<CasePolicy>::npos)
+                    {
+                        mergedSections.push_back(havINIMergedSection{ sectionName, {}, havINIHashIndex<CasePolicy>() });
+                        sectionSlot = mergedSections.size() - 1;
+                        sectionIndex.Insert(sectionName, sectionSlot);
+                    }
+
+                    havINIMergedSection& mergedSection = mergedSections[sectionSlot];
+
+                    for (std::uint32_t entryIndex = section.firstEntry; entryIndex < section.firstEntry + section.entryCount; ++entryIndex)
+                    {
+                        const havINISnapshotEntry& entry = layer.mEntries[entryIndex];
+                        std::string_view key = layer.View(entry.key);
+                        std::size_t entrySlot = mergedSection.keyIndex.Find(key, mergedSection.entries, [](const havINIMergedEntry& merged) -> std::string_view { return merged.key; });
+
+                        if (entrySlot == havINIHashIndex<CasePolicy>::npos)
+                        {
+                            mergedSection.entries.push_back(havINIMergedEntry{ key, layerIndex, &entry });
+                            mergedSection.keyIndex.Insert(key, mergedSection.entries.size() - 1);
+                        }
+                        else
+                        {
+                            mergedSection.entries[entrySlot] = havINIMergedEntry{ key, layerIndex, &entry };
+                        }
+                    }
+                }
+            }
+
+            // The merged snapshot holds only the winning entries, so it has to be measured again
+            std::size_t poolSize = 0;
+            std::size_t entryCount = 0;
+            std::size_t elementCount = 0;
+
+            for (const havINIMergedSection& mergedSection : mergedSections)
+            {
+                poolSize += mergedSection.name.size();
+                entryCount += mergedSection.entries.size();
+
+                for (const havINIMergedEntry& mergedEntry : mergedSection.entries)
+                {
+                    const basic_havINISnapshot& layer = layers[mergedEntry.layer];
+                    const havINISnapshotEntry& entry = *mergedEntry.entry;
+
+                    poolSize += mergedEntry.key.size();
+
+                    if (entry.isArray == true)
+                    {
+                        elementCount += entry.value.size;
+
+                        for (std::uint32_t elementIndex = entry.value.offset; elementIndex < entry.value.offset + entry.value.size; ++elementIndex)
+                        {
+                            poolSize += layer.mElements[elementIndex].key.size + layer.mElements[elementIndex].value.size;
+                        }
+                    }
+                    else
+                    {
+                        poolSize += entry.value.size;
+                    }
+                }
+            }
+
+            CheckSize(poolSize, mergedSections.size(), entryCount, elementCount);
+
+            havINISnapshotBuilder builder;
+            builder.pool.reserve(poolSize);
+            builder.sections.reserve(mergedSections.size());
+            builder.entries.reserve(entryCount);
+            builder.elements.reserve(elementCount);
+
+            entryLayers.clear();
+            entryLayers.reserve(entryCount);
+
+            for (const havINIMergedSection& mergedSection : mergedSections)
+            {
+                havINISnapshotSection newSection;
+                newSection.name = AddToPool(builder.pool, mergedSection.name);
+                newSection.firstEntry = static_cast<std::uint32_t>(builder.entries.size());
+
+                for (const havINIMergedEntry& mergedEntry : mergedSection.entries)
+                {
+                    const basic_havINISnapshot& layer = layers[mergedEntry.layer];
+                    const havINISnapshotEntry& entry = *mergedEntry.entry;
+
+                    havINISnapshotEntry newEntry;
+                    newEntry.key = AddToPool(builder.pool, mergedEntry.key);
+                    newEntry.hash = entry.hash;
+                    newEntry.isArray = entry.isArray;
+
+                    if (entry.isArray == true)
+                    {
+                        // Arrays are replaced as a whole
+                        newEntry.value.offset = static_cast<std::uint32_t>(builder.elements.size());
+
+                        for (std::uint32_t elementIndex = entry.value.offset; elementIndex < entry.value.offset + entry.value.size; ++elementIndex)
+                        {
+                            havINISnapshotString elementKey = AddToPool(builder.pool, layer.View(layer.mElements[elementIndex].key));
+
+                            builder.elements.push_back(havINISnapshotElement{ elementKey, AddToPool(builder.pool, layer.View(layer.mElements[elementIndex].value)) });
+                        }
+
+                        newEntry.value.size = entry.value.size;
+                    }
+                    else
+                    {
+                        newEntry.value = AddToPool(builder.pool, layer.View(entry.value));
+                    }
+
+                    builder.entries.push_back(newEntry);
+                    entryLayers.push_back(mergedEntry.layer);
+                }
+
+                newSection.entryCount = static_cast<std::uint32_t>(builder.entries.size()) - newSection.firstEntry;
+                builder.sections.push_back(newSection);
+            }
+
+            basic_havINISnapshot mergedSnapshot;
+
+            BuildBuckets(builder);
+            mergedSnapshot.SetImage(builder);
+
+            return mergedSnapshot;
+        }
+
+        // Copy of the image with the checksum and the source hash, as it is written by basic_havINIStream::SaveCompiled
+        std::string GetFileImage(std::uint64_t sourceHash) const
+        {
+            if (mImage == nullptr)
+            {
+                return std::string();
+            }
+
+            std::string image(mImage.get(), mImageSize);
+            havINISnapshotHeader header;
+
+            std::memcpy(&header, image.data(), sizeof(header));
+            header.sourceHash = sourceHash;
+            header.checksum = havUtils::HashBytes(std::string_view(image).substr(sizeof(header)));
+            std::memcpy(&image[0], &header, sizeof(header));
+
+            return image;
+        }
+
+        // Returns the table at the position and moves the position behind it
+        template<typename T>
+        static havINISnapshotTable<T> MapTable(const char*& position, std::size_t count)
+        {
+            havINISnapshotTable<T> table{ reinterpret_cast<const T*>(position), count };
+
+            position += count * sizeof(T);
+
+            return table;
+        }
+
+        std::uint32_t FindSection(std::string_view sectionName) const
+        {
+            if (mSectionBuckets.empty() == true)
+            {
+                return npos;
+            }
+
+            // Like in the stream, an empty section name refers to the global section
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            std::uint32_t hash = static_cast<std::uint32_t>(CasePolicy::Hash(sectionName));
+            std::size_t mask = mSectionBuckets.size() - 1;
+
+            for (std::size_t bucket = hash & mask; mSectionBuckets[bucket].index != 0; bucket = (bucket + 1) & mask)
+            {
+                const havINISnapshotBucket& currentBucket = mSectionBuckets[bucket];
+
+                if (currentBucket.hash == hash && CasePolicy::Equal(View(mSections[currentBucket.index - 1].name), sectionName) == true)
+                {
+                    return currentBucket.index - 1;
+                }
+            }
+
+            return npos;
+        }
+
+        const havINISnapshotEntry* FindEntry(std::string_view sectionName, std::string_view keyName) const
+        {
+            std::uint32_t sectionIndex = FindSection(sectionName);
+
+            if (sectionIndex == npos)
+            {
+                return nullptr;
+            }
+
+            return FindEntry(mSections[sectionIndex], keyName);
+        }
+
+        const havINISnapshotEntry* FindEntry(const havINISnapshotSection& section, std::string_view keyName) const
+        {
+            std::uint32_t hash = static_cast<std::uint32_t>(CasePolicy::Hash(keyName));
+
+            if (section.bucketCount == 0)
+            {
+                // Small sections are searched linearly, the stored hash avoids most string compares
+                for (std::uint32_t entryIndex = section.firstEntry; entryIndex < section.firstEntry + section.entryCount; ++entryIndex)
+                {
+                    const havINISnapshotEntry& entry = mEntries[entryIndex];
+
+                    if (entry.hash == hash && CasePolicy::Equal(View(entry.key), keyName) == true)
+                    {
+                        return &entry;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            const havINISnapshotBucket* buckets = mEntryBuckets.data() + section.firstBucket;
+            std::uint32_t mask = section.bucketCount - 1;
+
+            for (std::uint32_t bucket = hash & mask; buckets[bucket].index != 0; bucket = (bucket + 1) & mask)
+            {
+                if (buckets[bucket].hash == hash && CasePolicy::Equal(View(mEntries[buckets[bucket].index - 1].key), keyName) == true)
+                {
+                    return &mEntries[buckets[bucket].index - 1];
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Arrays are usually small, so their entries are searched linearly
+        const havINISnapshotElement* FindElement(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey) const
+        {
+            const havINISnapshotEntry* entry = FindEntry(sectionName, keyName);
+
+            if (entry == nullptr || entry->isArray == false)
+            {
+                return nullptr;
+            }
+
+            for (std::uint32_t elementIndex = entry->value.offset; elementIndex < entry->value.offset + entry->value.size; ++elementIndex)
+            {
+                if (CasePolicy::Equal(View(mElements[elementIndex].key), arrayKey) == true)
+                {
+                    return &mElements[elementIndex];
+                }
+            }
+
+            return nullptr;
+        }
+
+        template<class, class>
+        friend class basic_havINIStream;
+
+        template<class>
+        friend class basic_havINIOverlay;
+
+        std::shared_ptr<const char> mImage; // Owns the memory of the tables and the pool
+        std::size_t mImageSize = 0;
+
+        std::string_view mPool;
+        havINISnapshotTable<havINISnapshotSection> mSections;
+        havINISnapshotTable<havINISnapshotEntry> mEntries;
+        havINISnapshotTable<havINISnapshotElement> mElements;
+        havINISnapshotTable<havINISnapshotBucket> mSectionBuckets; // Section name -> index in mSections
+        havINISnapshotTable<havINISnapshotBucket> mEntryBuckets; // Key -> index in mEntries, one range per section
+    };
+
+    template<class CasePolicy, class Allocator>
+    class basic_havINIStream
+    {
+    public:
+        using havINIData = basic_havINIData<CasePolicy, Allocator>;
+        using havINISection = basic_havINISection<CasePolicy, Allocator>;
+        using allocator_type = Allocator;
+        using havINIDataVector = typename havINIData::havINIDataVector;
+        using havINISectionVector = std::vector<havINISection, typename std::allocator_traits<Allocator>::template rebind_alloc<havINISection>>;
+
+        basic_havINIStream() : basic_havINIStream(Allocator())
+        {
+        }
+
+        // All sections, key value pairs and strings of the document are allocated with the allocator
+        explicit basic_havINIStream(const Allocator& allocator) : mData(allocator), mSectionIndex(allocator), mSourceSections(allocator),
+            mPendingRanges(allocator), mPendingSections(allocator)
+        {
+            std::string globalSectionName = "HI_Global";
+            CasePolicy::Fold(globalSectionName);
+
+            mData.emplace_back(globalSectionName);
+            mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
+        }
+
+        havINISection& operator[](int index)
+        {
+            if (index < 0 || static_cast<std::size_t>(index) >= mData.size())
+            {
+                throw std::out_of_range("Index is out of range!");
+            }
+
+            if (IsSectionPending(index) == true)
+            {
+                ParsePendingSection(index);
+            }
+
+            return mData[index];
+        }
+
+        havINISection& operator[](char sectionName)
+        {
+            return operator[](std::string_view(&sectionName, 1));
+        }
+
+        // The section name is only copied, if a new section has to be added
+        havINISection& operator[](std::string_view sectionName)
+        {
+            auto foundSection = FindSection(sectionName);
+
+            if (foundSection == mData.end())
+            {
+                std::string newSectionName(sectionName);
+
+                CasePolicy::Fold(newSectionName);
+
+                mData.emplace_back(newSectionName);
+                mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
+                foundSection = std::prev(mData.end());
+            }
+
+            return *foundSection;
+        }
+
+        std::string CodePointToString(const unsigned int codePoint)
+        {
+            // Note: null-terminated string
+            char value[5] = { '\0' };
+
+            if (codePoint < 0x80)
+            {
+                value[0] = codePoint;
+            }
+            else if (codePoint < 0x800)
+            {
+                value[0] = (codePoint >> 6) | 0xc0;
+                value[1] = (codePoint & 0x3f) | 0x80;
+            }
+            else if (codePoint < 0x10000)
+            {
+                value[0] = (codePoint >> 12) | 0xe0;
+                value[1] = ((codePoint >> 6) & 0x3f) | 0x80;
+                value[2] = (codePoint & 0x3f) | 0x80;
+            }
+            else if (codePoint < 0x110000)
+            {
+                value[0] = (codePoint >> 18) | 0xf0;
+                value[1] = ((codePoint >> 12) & 0x3f) | 0x80;
+                value[2] = ((codePoint >> 6) & 0x3f) | 0x80;
+                value[3] = (codePoint & 0x3f) | 0x80;
+            }
+
+            return std::string(value);
+        }
+
+        std::string ConvertToEscapedString(std::string_view value)
+        {
+            std::string resultValue;
+
+            unsigned int codePoint = 0;
+            int numOfBytes = 0;
+            bool writeAsHex = false;
+
+            for (std::string_view::size_type index = 0; index < value.size(); ++index)
+            {
+                switch (value[index])
+                {
+                case '"':
+                    resultValue += "\\\"";
+                    break;
+
+                case '\\':
+                    resultValue += "\\\\";
+                    break;
+
+                case '\b':
+                    resultValue += "\\b";
+                    break;
+
+                case '\f':
+                    resultValue += "\\f";
+                    break;
+
+                case '\n':
+                    resultValue += "\\n";
+                    break;
+
+                case '\r':
+                    resultValue += "\\r";
+                    break;
+
+                case '\t':
+                    resultValue += "\\t";
+                    break;
+
+                case '\v':
+                    resultValue += "\\v";
+                    break;
+
+                default:
+                    {
+                        writeAsHex = false;
+                        codePoint = 0;
+
+                        if ((value[index] & 0x80) == 0x00)
+                        {
+                            numOfBytes = 1;
+
+                            if (value[index] < 0x1f)
+                            {
+                                writeAsHex = true;
+
+                                codePoint = (value[index] & 0x7f);
+                            }
+                        }
+                        else if ((value[index] & 0xe0) == 0xc0)
+                        {
+                            numOfBytes = 2;
+
+                            writeAsHex = true;
+
+                            codePoint = (value[index] & 0x1f);
+                        }
+                        else if ((value[index] & 0xf0) == 0xe0)
+                        {
+                            numOfBytes = 3;
+
+                            writeAsHex = true;
+
+                            codePoint = (value[index] & 0x0f);
+                        }
+                        else if ((value[index] & 0xf8) == 0xf0)
+                        {
+                            numOfBytes = 4;
+
+                            writeAsHex = true;
+
+                            codePoint = (value[index] & 0x07);
+                        }
+                        else
+                        {
+                            throw std::runtime_error("Invalid UTF-8 sequence!");
+                        }
+
+                        for (int byteCount = 1; byteCount < numOfBytes; ++byteCount)
+                        {
+                            if ((value[++index] & 0xc0) != 0x80)
+                            {
+                                throw std::runtime_error("Invalid UTF-8 sequence!");
+                            }
+
+                            codePoint = (codePoint << 6) | (value[index] & 0x3f);
+                        }
+
+                        if (writeAsHex == true)
+                        {
+                            std::ostringstream outputStringStream;
+
+                            // Code point is UTF-16 surrogate pair
+                            if (codePoint >= 0x10000 && codePoint <= 0x10ffff)
+                            {
+                                codePoint -= 0x10000;
+
+                                unsigned int highSurrogate = (codePoint / 0x400) + 0xd800;
+                                unsigned int lowSurrogate = (codePoint % 0x400) + 0xdc00;
+
+                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << highSurrogate;
+                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << lowSurrogate;
+
+                                resultValue += outputStringStream.str();
+                            }
+                            else
+                            {
+                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << codePoint;
+
+                                resultValue += outputStringStream.str();
+                            }
+                        }
+                        else
+                        {
+                            resultValue += static_cast<unsigned int>(value[index]);
+                        }
+                    }
+                    break;
+                }
+            }
+
+            return resultValue;
+        }
+
+        // The file is read in blocks of HAVINI_READ_CHUNK_SIZE bytes and each block is parsed right away, so only the document grows with the file size.
+        // Lazy and parallel parsing need the whole contents at once, the file is read completely for them.
+        bool ParseFile(const std::string& fileName)
+        {
+            ResetParseStats();
+
+            havINIFileState fileState = GetFileState(fileName);
+
+            if (CanParseLazily() == false && mParseThreadCount == 1)
+            {
+                if (ParseContentsInBlocks([&](auto parseBlock) -> bool { return ReadFileInChunks(fileName, parseBlock); }) == false)
+                {
+                    return false;
+                }
+
+                mSourceFileName = fileName;
+                mSourceFileState = fileState;
+
+                return true;
+            }
+
+            std::string fileBuffer;
+
+            if (ReadFile(fileName, fileBuffer) == false)
+            {
+                return false;
+            }
+
+            std::string convertedFileContents;
+            std::string_view fileContents;
+
+            if (DecodeBuffer(fileBuffer.data(), fileBuffer.size(), havINIBOMType::None, convertedFileContents, fileContents) == false)
+            {
+                return false;
+            }
+
+            if (CanParseLazily() == true)
+            {
+                // The file buffer is taken over instead of being copied, only a BOM has to be skipped
+                if (fileContents.data() != convertedFileContents.data())
+                {
+                    std::size_t contentsStart = static_cast<std::size_t>(fileContents.data() - fileBuffer.data());
+
+                    return ParseLazily(std::move(fileBuffer), contentsStart);
+                }
+
+                return ParseLazily(std::move(convertedFileContents), 0);
+            }
+
+            std::size_t parseTaskCount = GetParseTaskCount(fileContents.size());
+
+            if (parseTaskCount > 1)
+            {
+                if (ParseInParallel(fileContents, parseTaskCount) == false)
+                {
+                    return false;
+                }
+            }
+            else if (ParseContents(fileContents) == false)
+            {
+                return false;
+            }
+
+            mSourceFileName = fileName;
+            mSourceFileState = fileState;
+
+            return true;
+        }
+
+        // Parses INI data from memory, e.g. a string received over the network
+        bool ParseString(std::string_view contents)
+        {
+            return ParseBuffer(contents.data(), contents.size());
+        }
+
+        // Parses INI data from memory, the encoding is detected automatically, if bomType is havINIBOMType::None
+        bool ParseBuffer(const void* data, std::size_t size, havINIBOMType bomType = havINIBOMType::None)
+        {
+            ResetParseStats();
+
+            std::string convertedFileContents;
+            std::string_view fileContents;
+
+            if (DecodeBuffer(data, size, bomType, convertedFileContents, fileContents) == false)
+            {
+                return false;
+            }
+
+            if (CanParseLazily() == true)
+            {
+                // The sections are parsed after this call returns, so the contents are copied unless they were converted anyway
+                if (fileContents.data() != convertedFileContents.data())
+                {
+                    convertedFileContents.assign(fileContents);
+                }
+
+                return ParseLazily(std::move(convertedFileContents), 0);
+            }
+
+            std::size_t parseTaskCount = GetParseTaskCount(fileContents.size());
+
+            if (parseTaskCount > 1)
+            {
+                return ParseInParallel(fileContents, parseTaskCount);
+            }
+
+            return ParseContents(fileContents);
+        }
+
+        // Parses a file without building a document, every line is passed to the handler (e.g. a class derived from havINIEventHandler) instead.
+        // Parse errors are reported like by ParseFile and return havINIParseResult::Failed, the settings of the stream are used for the parsing.
+        // The file is read in blocks of HAVINI_READ_CHUNK_SIZE bytes, so the memory use doesn't depend on the file size.
+        template<class Handler>
+        havINIParseResult ParseFileEvents(const std::string& fileName, Handler& handler)
+        {
+            ResetParseStats();
+
+            return ParseEventsInBlocks(handler, [&](auto parseBlock) -> bool { return ReadFileInChunks(fileName, parseBlock); });
+        }
+
+        template<class Handler>
+        havINIParseResult ParseStringEvents(std::string_view contents, Handler& handler)
+        {
+            return ParseBufferEvents(contents.data(), contents.size(), handler);
+        }
+
+        template<class Handler>
+        havINIParseResult ParseBufferEvents(const void* data, std::size_t size, Handler& handler, havINIBOMType bomType = havINIBOMType::None)
+        {
+            ResetParseStats();
+
+            std::string convertedFileContents;
+            std::string_view fileContents;
+
+            if (DecodeBuffer(data, size, bomType, convertedFileContents, fileContents) == false)
+            {
+                return havINIParseResult::Failed;
+            }
+
+            return ParseEventsInBlocks(handler, [&](auto parseBlock) -> bool { parseBlock(fileContents, true); return true; });
+        }
+
+        bool Parse(std::istream& inputStream)
+        {
+            // Read the whole stream at once, it is parsed from memory afterwards
+            std::string streamBuffer(std::istreambuf_iterator<char>(inputStream), {});
+
+            if (inputStream.bad() == true)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ReadFailed, "Unable to read INI stream!");
+
+                return false;
+            }
+
+            return ParseBuffer(streamBuffer.data(), streamBuffer.size());
+        }
+
+        // Reloads a file which was read with ParseFile, nothing is parsed if neither the modification time nor the contents changed.
+        // The file isn't even read, if its modification time and size are the same as last time and the modification time was older than that read by
+        // more than HAVINI_FILE_TIME_GRANULARITY seconds. Otherwise a write within the granularity of the file system could have kept the modification time,
+        // so the file is read and its sections are compared by their hashes. Only sections whose lines were changed are parsed again, the other sections
+        // are kept as they are. A file whose modification time was reset on purpose (e.g. by cp -p) with the same size is still taken as unchanged.
+        // The added, removed and changed keys are returned in changes, comments and empty lines are not reported.
+        bool ReloadFile(const std::string& fileName, havINIChangeSet& changes)
+        {
+            changes.clear();
+            ResetParseStats();
+
+            havINIFileState fileState = GetFileState(fileName);
+
+            if (mSourceSectionsValid == true && fileName == mSourceFileName && IsFileUnchanged(mSourceFileState, fileState) == true)
+            {
+                return true;
+            }
+
+            std::string fileBuffer;
+
+            if (ReadFile(fileName, fileBuffer) == false)
+            {
+                return false;
+            }
+
+            if (ReloadBuffer(fileBuffer.data(), fileBuffer.size(), changes) == false)
+            {
+                return false;
+            }
+
+            mSourceFileName = fileName;
+            mSourceFileState = fileState;
+
+            return true;
+        }
+
+        // Replaces the contents of the stream like ReloadFile, e.g. with data received over the network
+        bool ReloadString(std::string_view contents, havINIChangeSet& changes)
+        {
+            changes.clear();
+            ResetParseStats();
+
+            mSourceFileName.clear();
+
+            return ReloadBuffer(contents.data(), contents.size(), changes);
+        }
+
+        bool WriteFile(const std::string& fileName, bool formatted = false, havINIBOMType bomType = havINIBOMType::None)
+        {
+            // Build the encoded INI file contents first, so the file is written with a single call
+            std::string fileContents = WriteString(formatted, bomType);
+
+            std::uint64_t fileHash = 0;
+
+            if (mIncrementalWrite == true)
+            {
+                fileHash = havUtils::HashBytes(fileContents);
+
+                // Nothing changed and the file wasn't touched by anyone else since the last write
+                if (fileName == mWrittenFileName && fileHash == mWrittenHash && fileContents.size() == mWrittenSize &&
+                    mWrittenWriteTime != std::filesystem::file_time_type::min() && GetFileWriteTime(fileName) == mWrittenWriteTime)
+                {
+                    return true;
+                }
+
+                mWrittenFileName.clear();
+            }
+
+            bool isWritten = (mAtomicWrite == true) ? WriteFileAtomically(fileName, fileContents) : WriteFileContents(fileName, fileContents, false);
+
+            if (isWritten == false)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::WriteFailed, "Unable to write INI file: " + fileName);
+
+                return false;
+            }
+
+            if (mIncrementalWrite == true)
+            {
+                mWrittenFileName = fileName;
+                mWrittenWriteTime = GetFileWriteTime(fileName);
+                mWrittenHash = fileHash;
+                mWrittenSize = fileContents.size();
+            }
+
+            return true;
+        }
+
+        // Returns the INI data encoded as specified by bomType, including the BOM
+        std::string WriteString(bool formatted = false, havINIBOMType bomType = havINIBOMType::None)
+        {
+            return EncodeContents(BuildContents(formatted), bomType);
+        }
+
+        bool Write(std::ostream& outputStream, bool formatted = false, havINIBOMType bomType = havINIBOMType::None)
+        {
+            std::string contents = WriteString(formatted, bomType);
+
+            outputStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+            if (outputStream.good() == false)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::WriteFailed, "Unable to write INI stream!");
+
+                return false;
+            }
+
+            return true;
+        }
+
+        bool SetEmptyLine(std::string_view sectionName, const havINIPosition& position, std::optional<std::string> keyName = std::nullopt)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                std::string emptyLineKeyStart = "HI_EL_";
+
+                CasePolicy::Fold(emptyLineKeyStart);
+
+                if (keyName.has_value() == true)
+                {
+                    CasePolicy::Fold(keyName.value());
+                }
+
+                sectionEntry->SetEmptyLine(emptyLineKeyStart + std::to_string(sectionEntry->GetEmptyLineCount()), position, keyName);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        std::vector<std::string> GetEmptyLineKeyNames(std::string_view sectionName)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                std::string emptyLineKeyStart = "HI_EL_";
+
+                CasePolicy::Fold(emptyLineKeyStart);
+
+                return sectionEntry->GetEmptyLineKeyNames(emptyLineKeyStart);
+            }
+
+            return {};
+        }
+
+        bool RemoveEmptyLine(std::string_view sectionName, std::string_view keyName)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                return sectionEntry->RemoveEmptyLine(keyName);
+            }
+
+            return false;
+        }
+
+        bool AddSection(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry == mData.end())
+            {
+                std::string newSectionName(sectionName);
+
+                CasePolicy::Fold(newSectionName);
+
+                mData.emplace_back(newSectionName);
+                mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        std::string GetValue(std::string_view sectionName, std::string_view keyName, const std::string& defaultValue)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != keyValuePairs.end())
+                {
+                    return std::string(keyValuePair->GetValue());
+                }
+            }
+
+            return defaultValue;
+        }
+
+        // Returns a view of the stored value without copying it, the view is only valid until the key-value pair is changed or removed
+        std::string_view GetValueView(std::string_view sectionName, std::string_view keyName, std::string_view defaultValue = {})
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != keyValuePairs.end())
+                {
+                    return keyValuePair->GetValue();
+                }
+            }
+
+            return defaultValue;
+        }
+
+        // Like GetValueView for many keys of one section, the section is only searched once (see basic_havINISection::GetValues)
+        template<class KeyRange, class ValueRange>
+        std::size_t GetValues(std::string_view sectionName, const KeyRange& keyNames, ValueRange&& values, std::string_view defaultValue = {})
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                return sectionEntry->GetValues(keyNames, values, defaultValue);
+            }
+
+            if (std::size(values) < std::size(keyNames))
+            {
+                throw std::out_of_range("There must be a value for every key!");
+            }
+
+            std::fill_n(std::begin(values), std::size(keyNames), defaultValue);
+
+            return 0;
+        }
+
+        // Returns the section without adding it, nullptr if it doesn't exist. Lookups through the section skip the search for the section name,
+        // the pointer is only valid until a section is added or removed.
+        havINISection* FindSectionHandle(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            return (sectionEntry == mData.end()) ? nullptr : std::addressof(*sectionEntry);
+        }
+
+        template<typename T>
+        T GetValueAs(std::string_view sectionName, std::string_view keyName, T defaultValue)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != sectionEntry->GetKeyValuePairs().end() && keyValuePair->GetType() == havINIDataType::Value)
+                {
+                    return keyValuePair->GetValueAs(defaultValue);
+                }
+            }
+
+            return defaultValue;
+        }
+
+        template<typename T>
+        T GetArrayValueAs(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey, T defaultValue)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != sectionEntry->GetKeyValuePairs().end() && keyValuePair->GetType() == havINIDataType::Array)
+                {
+                    return keyValuePair->GetArrayValueAs(arrayKey, defaultValue);
+                }
+            }
+
+            return defaultValue;
+        }
+
+        template<typename T>
+        std::vector<T> GetArrayValuesAs(std::string_view sectionName, std::string_view keyName, T defaultValue)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != sectionEntry->GetKeyValuePairs().end() && keyValuePair->GetType() == havINIDataType::Array)
+                {
+                    return keyValuePair->GetArrayValuesAs(defaultValue);
+                }
+            }
+
+            return {};
+        }
+
+        bool SetValue(std::string_view sectionName, std::string_view keyName, const std::string& value, bool addQuotes)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
+
+                if (keyValuePair != keyValuePairs.end())
+                {
+                    keyValuePair->SetValue(value);
+                    keyValuePair->SetAddQuotes(addQuotes);
+
+                    return true;
+                }
+                else
+                {
+                    sectionEntry->SetKeyValuePair(keyName, value, addQuotes);
+
+                    return true;
+                }
+            }
+            else
+            {
+                std::string newSectionName(sectionName);
+
+                CasePolicy::Fold(newSectionName);
+
+                mData.emplace_back(newSectionName);
+                mData.back().SetKeyValuePair(keyName, value, addQuotes);
+                mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        bool SetComment(std::string_view sectionName, const std::string& comment, const havINIPosition& position, std::optional<std::string> keyName = std::nullopt)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            if (keyName.has_value() == true)
+            {
+                CasePolicy::Fold(keyName.value());
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                std::string commentKeyStart = "HI_C_";
+                CasePolicy::Fold(commentKeyStart);
+
+                sectionEntry->SetComment(commentKeyStart + std::to_string(sectionEntry->GetCommentLineCount()), comment, position, keyName);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        std::vector<std::string> GetCommentKeyNames(std::string_view sectionName)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                std::string commentKeyStart = "HI_C_";
+                CasePolicy::Fold(commentKeyStart);
+
+                return sectionEntry->GetCommentKeyNames(commentKeyStart);
+            }
+
+            return {};
+        }
+
+        bool RemoveComment(std::string_view sectionName, std::string_view keyName)
+        {
+            if (sectionName.empty() == true)
+            {
+                sectionName = "HI_Global";
+            }
+
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                return sectionEntry->RemoveComment(keyName);
+            }
+
+            return false;
+        }
+
+        bool SetInlineComment(std::string_view sectionName, std::string_view keyName, const std::string& inlineComment)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
+
+                if (keyValuePair != keyValuePairs.end())
+                {
+                    keyValuePair->SetInlineComment(inlineComment);
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool RemoveKey(std::string_view sectionName, std::string_view keyName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                auto keyValuePair = sectionEntry->FindKeyValuePair(keyName);
+
+                if (keyValuePair != keyValuePairs.end())
+                {
+                    sectionEntry->RemoveKeyValuePair(keyValuePair);
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool RemoveSection(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                std::size_t slot = static_cast<std::size_t>(sectionEntry - mData.begin());
+
+                if (slot < mPendingSections.size())
+                {
+                    mPendingSections.erase(mPendingSections.begin() + slot);
+                }
+
+                mData.erase(sectionEntry);
+                mSectionIndex.Invalidate();
+                mSourceSectionsValid = false;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        bool RenameKey(std::string_view sectionName, std::string_view oldKeyName, std::string_view newKeyName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                const havINIDataVector& keyValuePairs = sectionEntry->GetKeyValuePairs();
+
+                if (sectionEntry->FindKeyValuePair(newKeyName) == keyValuePairs.end())
+                {
+                    auto keyValuePair = sectionEntry->FindKeyValuePair(oldKeyName);
+
+                    if (keyValuePair != keyValuePairs.end())
+                    {
+                        sectionEntry->SetKey(std::string(newKeyName), keyValuePair);
+
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        bool RenameSection(std::string_view oldSectionName, std::string_view newSectionName)
+        {
+            if (FindSection(newSectionName) == mData.end())
+            {
+                auto sectionEntry = FindSection(oldSectionName);
+
+                if (sectionEntry != mData.end())
+                {
+                    sectionEntry->SetSectionName(std::string(newSectionName));
+                    mSectionIndex.Invalidate();
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool SetSectionInlineComment(std::string_view sectionName, const std::string& inlineComment)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                sectionEntry->SetInlineComment(inlineComment);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        typename havINIDataVector::size_type GetNumberOfKeys(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry == mData.end())
+            {
+                return 0;
+            }
+
+            return sectionEntry->GetNumberOfKeys();
+        }
+
+        typename havINISectionVector::size_type GetNumberOfSections()
+        {
+            return mData.size();
+        }
+
+        bool HasKey(std::string_view sectionName, std::string_view keyName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                return sectionEntry->HasKey(keyName);
+            }
+
+            return false;
+        }
+
+        // A section which has not been parsed yet stays untouched
+        bool HasSection(std::string_view sectionName)
+        {
+            return FindSectionSlot(sectionName) != havINIHashIndex<CasePolicy, Allocator>::npos;
+        }
+
+        // Returns an immutable copy of the current document for fast, lock-free lookups, later changes of the stream are not reflected.
+        // Freeze parses the sections which lazy parsing skipped so far, so it must not be called concurrently with other calls on the stream.
+        basic_havINISnapshot<CasePolicy> Freeze()
+        {
+            ParsePendingSections();
+
+            return basic_havINISnapshot<CasePolicy>(mData);
+        }
+
+        // Writes the snapshot of the document (see Freeze) as a binary image, which LoadCompiled maps into memory instead of parsing the INI file.
+        // The hash of sourceFileName is stored in the image, it's written like with SetAtomicWrite, so a reader never sees a partial image.
+        bool SaveCompiled(const std::string& fileName, const std::string& sourceFileName)
+        {
+            std::string sourceBuffer;
+
+            if (ReadFile(sourceFileName, sourceBuffer) == false)
+            {
+                return false;
+            }
+
+            return WriteCompiledFile(fileName, Freeze(), HashSource(sourceBuffer));
+        }
+
+        // Maps the image written by SaveCompiled into memory, the snapshot reads its tables in place. If the image is missing, damaged or was compiled
+        // from other contents of sourceFileName, sourceFileName is parsed into the stream and the image is written again for the next start.
+        bool LoadCompiled(const std::string& fileName, const std::string& sourceFileName, basic_havINISnapshot<CasePolicy>& snapshot)
+        {
+            std::string sourceBuffer;
+
+            if (ReadFile(sourceFileName, sourceBuffer) == false)
+            {
+                return false;
+            }
+
+            std::uint64_t sourceHash = HashSource(sourceBuffer);
+
+            if (MapCompiledFile(fileName, sourceHash, snapshot) == true)
+            {
+                return true;
+            }
+
+            if (ParseBuffer(sourceBuffer.data(), sourceBuffer.size()) == false)
+            {
+                return false;
+            }
+
+            snapshot = Freeze();
+
+            // The snapshot can be used even if the image can't be written
+            WriteCompiledFile(fileName, snapshot, sourceHash);
+
+            return true;
+        }
+
+        bool ClearSection(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
+
+            if (sectionEntry != mData.end())
+            {
+                sectionEntry->Clear();
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void SetNewline(const std::string& newline)
+        {
+            if (newline != "\n" && newline != "\r" && newline != "\r\n")
+            {
+                throw std::runtime_error("Only \"\", \"\" or \"\" are allowed as new line!");
+            }
+
+            mNewline = newline;
+        }
+
+        void SetCommentCharacter(char commentCharacter)
+        {
+            if (commentCharacter != ';' && commentCharacter != '#')
+            {
+                throw std::runtime_error("Only \";\" or \"#\" are allowed as comment character!");
+            }
+
+            mCommentCharacter = commentCharacter;
+        }
+
+        void SetValueQuoteCharacter(char valueQuoteCharacter)
+        {
+            if (valueQuoteCharacter != '\"' && valueQuoteCharacter != '\'')
+            {
+                throw std::runtime_error("Only \"\"\" or \"\'\" are allowed as quote character!");
+            }
+
+            mValueQuoteCharacter = valueQuoteCharacter;
+        }
+
+        void SetKeyValuePairDelimiter(char keyValuePairDelimiter)
+        {
+            if (keyValuePairDelimiter != '=' && keyValuePairDelimiter != ':')
+            {
+                throw std::runtime_error("Only \"=\" or \":\" are allowed as key value pair delimiter!");
+            }
+
+            mKeyValuePairDelimiter = keyValuePairDelimiter;
+        }
+
+        void SetLocale(const std::locale& value)
+        {
+            mLocale = value;
+        }
+
+        // Comments, empty lines and inline comments which are switched off are skipped while parsing, e.g. if the file is never written back.
+        // Nothing is stored for them, so WriteFile and WriteString only write the sections and key-value pairs.
+        void SetKeepComments(bool keepComments)
+        {
+            mKeepComments = keepComments;
+        }
+
+        void SetKeepEmptyLines(bool keepEmptyLines)
+        {
+            mKeepEmptyLines = keepEmptyLines;
+        }
+
+        void SetKeepInlineComments(bool keepInlineComments)
+        {
+            mKeepInlineComments = keepInlineComments;
+        }
+
+        // Only the section headers are read by ParseFile, ParseString and ParseBuffer, the lines of a section are parsed when the section is accessed for
+        // the first time. Parse errors within a section (Including invalid escape sequences) are reported on that access with the same line as without
+        // lazy parsing, but they only stop the parsing of the section instead of skipping everything behind the error. The stream keeps a copy of
+        // the contents until every section has been parsed. Contents which are added to a stream that isn't empty are always parsed at once.
+        void SetLazyParsing(bool lazyParsing)
+        {
+            mLazyParsing = lazyParsing;
+        }
+
+        // Contents of at least HAVINI_PARALLEL_PARSE_CHUNK_SIZE bytes per thread are split at the section headers and parsed by up to threadCount
+        // threads (Zero uses every hardware thread). Like lazy parsing, this only applies to contents which are parsed into an empty stream.
+        void SetParseThreadCount(unsigned int threadCount)
+        {
+            mParseThreadCount = threadCount;
+        }
+
+        // Runs the tasks of a parallel parse instead of new threads, e.g. on a thread pool. The executor has to call task(0) to task(taskCount - 1)
+        // and may only return, when all of them are finished.
+        void SetParseExecutor(havINIParseExecutor executor)
+        {
+            mParseExecutor = std::move(executor);
+        }
+
+        // Every section keeps a copy of the contents it was written with, so WriteFile, WriteString and Write only build the sections which were
+        // changed since the last write. WriteFile doesn't touch the file, if its contents and modification time are the same as after the last write.
+        void SetIncrementalWrite(bool incrementalWrite)
+        {
+            mIncrementalWrite = incrementalWrite;
+
+            if (incrementalWrite == false)
+            {
+                mWrittenFormat.clear();
+                mWrittenFileName.clear();
+
+                for (havINISection& section : mData)
+                {
+                    section.mIsModified = true;
+                    section.mWrittenContents.clear();
+                    section.mWrittenContents.shrink_to_fit();
+                }
+            }
+        }
+
+        // WriteFile writes to a temporary file next to the file, flushes it to the disk and renames it over the file. A reader which reloads the file
+        // during the write sees the old contents and a crash doesn't leave a truncated file behind.
+        void SetAtomicWrite(bool atomicWrite)
+        {
+            mAtomicWrite = atomicWrite;
+        }
+
+        // Errors and notices are passed to the sink instead of being printed to std::cout, an empty sink prints them again
+        void SetDiagnosticSink(havINIDiagnosticSink diagnosticSink)
+        {
+            mDiagnosticSink = std::move(diagnosticSink);
+        }
+
+        // Every parse and reload call resets the parse stats and measures its phases, so GetParseStats returns the stats of the last call.
+        // The lines are timed one by one, which slows the parsing down a bit.
+        void SetCollectParseStats(bool collectParseStats)
+        {
+            mCollectParseStats = collectParseStats;
+        }
+
+        const std::string& GetNewline() const { return mNewline; }
+        char GetCommentCharacter() const { return mCommentCharacter; }
+        char GetValueQuoteCharacter() const { return mValueQuoteCharacter; }
+        char GetKeyValuePairDelimiter() const { return mKeyValuePairDelimiter; }
+        std::locale GetLocale() const { return mLocale; }
+        bool GetKeepComments() const { return mKeepComments; }
+        bool GetKeepEmptyLines() const { return mKeepEmptyLines; }
+        bool GetKeepInlineComments() const { return mKeepInlineComments; }
+        bool GetLazyParsing() const { return mLazyParsing; }
+        bool GetIncrementalWrite() const { return mIncrementalWrite; }
+        bool GetAtomicWrite() const { return mAtomicWrite; }
+        bool GetCollectParseStats() const { return mCollectParseStats; }
+        const havINIParseStats& GetParseStats() const { return mParseStats; }
+        unsigned int GetParseThreadCount() const { return mParseThreadCount; }
+
+#ifdef _WIN32
+        std::wstring ConvertStringToWString(const std::string& value)
+        {
+            int numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, nullptr, 0);
+
+            std::wstring wstr(numOfChars, 0);
+
+            numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, &wstr[0], numOfChars);
+
+            if (numOfChars > 0)
+            {
+                return wstr;
+            }
+
+            return std::wstring();
+        }
+#endif
+
+    private:
+        // Sections of the parsed contents in file order, ReloadFile only parses the sections whose hash changed
+        struct havINISourceSection
+        {
+            std::size_t slot; // Slot of the section in mData
+            std::size_t size;
+            std::uint64_t hash;
+        };
+
+        using havINISourceSectionVector = std::vector<havINISourceSection, typename std::allocator_traits<Allocator>::template rebind_alloc<havINISourceSection>>;
+
+        // Lines of a section which haven't been parsed yet, see SetLazyParsing
+        struct havINIPendingRange
+        {
+            std::size_t start; // Offset in mPendingContents
+            std::size_t size;
+            std::size_t next; // Next range of the same section
+            std::size_t line; // Line number of the first line, so errors are reported with the same line as by ParseContents
+        };
+
+        using havINIPendingRangeVector = std::vector<havINIPendingRange, typename std::allocator_traits<Allocator>::template rebind_alloc<havINIPendingRange>>;
+        using havINIPendingSlotVector = std::vector<std::size_t, typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>>;
+
+        std::filesystem::file_time_type GetFileWriteTime(const std::string& fileName)
+        {
+            std::error_code errorCode;
+
+#ifdef _WIN32
+            std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(std::filesystem::path(ConvertStringToWString(fileName)), errorCode);
+#else
+            std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(std::filesystem::path(fileName), errorCode);
+#endif
+
+            // An unknown modification time never matches, so the file is read again
+            return (errorCode) ? std::filesystem::file_time_type::min() : writeTime;
+        }
+
+        // Modification time and size of a file, looked up right before the file is read
+        struct havINIFileState
+        {
+            std::filesystem::file_time_type writeTime = std::filesystem::file_time_type::min();
+            std::uintmax_t size = 0;
+            std::filesystem::file_time_type readTime = std::filesystem::file_time_type::min();
+        };
+
+        havINIFileState GetFileState(const std::string& fileName)
+        {
+            std::error_code errorCode;
+
+#ifdef _WIN32
+            std::uintmax_t fileSize = std::filesystem::file_size(std::filesystem::path(ConvertStringToWString(fileName)), errorCode);
+#else
+            std::uintmax_t fileSize = std::filesystem::file_size(std::filesystem::path(fileName), errorCode);
+#endif
+
+            havINIFileState fileState;
+            fileState.writeTime = (errorCode) ? std::filesystem::file_time_type::min() : GetFileWriteTime(fileName);
+            fileState.size = (errorCode) ? 0 : fileSize;
+            fileState.readTime = std::filesystem::file_time_type::clock::now();
+
+            return fileState;
+        }
+
+        // A modification time close to the last read could belong to a write which came after the read, so it's treated as unknown
+        static bool IsFileUnchanged(const havINIFileState& lastState, const havINIFileState& fileState)
+        {
+            return fileState.writeTime != std::filesystem::file_time_type::min() && fileState.writeTime == lastState.writeTime && fileState.size == lastState.size &&
+                lastState.readTime - lastState.writeTime > std::chrono::seconds(HAVINI_FILE_TIME_GRANULARITY);
+        }
+
+        // Passes an error or notice to the diagnostic sink, without a sink it's printed to std::cout
+        void Report(havINIDiagnosticType type, havINIDiagnosticCode code, std::string message, std::size_t line = 0)
+        {
+            if (mDiagnosticSink)
+            {
+                // The messages of the tokenizer end with a newline
+                while (message.empty() == false && message.back() == '\n')
+                {
+                    message.pop_back();
+                }
+
+                mDiagnosticSink(havINIDiagnostic{ type, code, std::move(message), line });
+            }
+            else if (code == havINIDiagnosticCode::ParseError)
+            {
+                std::cout << "Error while reading INI file: " << message << std::endl;
+            }
+            else
+            {
+                std::cout << message << "\n";
+            }
+        }
+
+        void ResetParseStats()
+        {
+            mParseStats = havINIParseStats();
+        }
+
+        // Null, if no parse stats are collected
+        havINIParseStats* GetCollectedParseStats()
+        {
+            return (mCollectParseStats == true) ? &mParseStats : nullptr;
+        }
+
+        // Adds the time until it's stopped or destroyed to a phase of the parse stats, nothing is measured without stats
+        class havINIStatsTimer
+        {
+            public:
+                // The time is also subtracted from the enclosing phase, e.g. the build time is measured within the tokenize time of a whole block
+                havINIStatsTimer(havINIParseStats* stats, std::chrono::nanoseconds havINIParseStats::* phase, std::chrono::nanoseconds havINIParseStats::* enclosingPhase = nullptr) :
+                    mStats(stats), mPhase(phase), mEnclosingPhase(enclosingPhase)
+                {
+                    if (mStats != nullptr)
+                    {
+                        mStart = std::chrono::steady_clock::now();
+                    }
+                }
+
+                havINIStatsTimer(const havINIStatsTimer&) = delete;
+                havINIStatsTimer& operator=(const havINIStatsTimer&) = delete;
+
+                ~havINIStatsTimer()
+                {
+                    Stop();
+                }
+
+                void Stop()
+                {
+                    if (mStats == nullptr)
+                    {
+                        return;
+                    }
+
+                    std::chrono::nanoseconds duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart);
+
+                    mStats->*mPhase += duration;
+
+                    if (mEnclosingPhase != nullptr)
+                    {
+                        mStats->*mEnclosingPhase -= duration;
+                    }
+
+                    mStats = nullptr;
+                }
+
+            private:
+                havINIParseStats* mStats;
+                std::chrono::nanoseconds havINIParseStats::* mPhase;
+                std::chrono::nanoseconds havINIParseStats::* mEnclosingPhase;
+                std::chrono::steady_clock::time_point mStart;
+        };
+
+        using havINIFilePointer = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+        // Writes the contents with a single call, flushToDisk waits until the operating system has stored them on the disk
+        bool WriteFileContents(const std::string& fileName, std::string_view fileContents, bool flushToDisk)
+        {
+#ifdef _WIN32
+            havINIFilePointer fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+            havINIFilePointer fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+            return WriteFileStream(std::move(fileStream), fileContents, flushToDisk);
+        }
+
+        // The file is closed in any case
+        static bool WriteFileStream(havINIFilePointer fileStream, std::string_view fileContents, bool flushToDisk)
+        {
+            if (fileStream == nullptr)
+            {
+                return false;
+            }
+
+            if (std::fwrite(fileContents.data(), sizeof(char), fileContents.size(), fileStream.get()) != fileContents.size())
+            {
+                return false;
+            }
+
+            if (flushToDisk == true)
+            {
+                if (std::fflush(fileStream.get()) != 0)
+                {
+                    return false;
+                }
+
+#ifdef _WIN32
+                if (FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fileStream.get())))) == FALSE)
+#else
+                if (fsync(fileno(fileStream.get())) != 0)
+#endif
+                {
+                    return false;
+                }
+            }
+
+            // The data may only be written when the file is closed
+            return std::fclose(fileStream.release()) == 0;
+        }
+
+        // Writes the contents to a temporary file next to the file and replaces the file with it, so readers either see the old or the new file
+        bool WriteFileAtomically(const std::string& fileName, std::string_view fileContents)
+        {
+#ifdef _WIN32
+            std::wstring wideFileName = ConvertStringToWString(fileName);
+            std::filesystem::path directoryName = std::filesystem::path(wideFileName).parent_path();
+            std::wstring wideTempFileName(MAX_PATH, L'\0');
+
+            // GetTempFileNameW creates a new file with a unique name, so concurrent writers never share the temporary file
+            if (GetTempFileNameW(directoryName.empty() == true ? L"." : directoryName.c_str(), L"hav", 0, &wideTempFileName[0]) == 0)
+            {
+                return false;
+            }
+
+            wideTempFileName.resize(wideTempFileName.find(L'\0'));
+
+            std::filesystem::path tempFileName(wideTempFileName);
+            havINIFilePointer fileStream(_wfopen(wideTempFileName.c_str(), L"wb"), std::fclose);
+#else
+            // mkstemp creates a new file with a unique name and doesn't follow symbolic links, so concurrent writers never share the temporary file
+            std::string tempFileName = fileName + ".XXXXXX";
+            int tempFile = mkstemp(&tempFileName[0]);
+
+            if (tempFile < 0)
+            {
+                return false;
+            }
+
+            struct stat fileStatus;
+
+            // The new file gets the permissions of the old one, mkstemp only grants access to the owner
+            fchmod(tempFile, (stat(fileName.c_str(), &fileStatus) == 0) ? (fileStatus.st_mode & 07777) : 0644);
+
+            havINIFilePointer fileStream(fdopen(tempFile, "wb"), std::fclose);
+
+            if (fileStream == nullptr)
+            {
+                close(tempFile);
+            }
+#endif
+
+            if (WriteFileStream(std::move(fileStream), fileContents, true) == false)
+            {
+                RemoveTempFile(tempFileName);
+
+                return false;
+            }
+
+#ifdef _WIN32
+            // ReplaceFileW keeps the attributes and the security descriptor of the file, but needs an existing file
+            bool isReplaced = ReplaceFileW(wideFileName.c_str(), wideTempFileName.c_str(), nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr) != FALSE ||
+                (GetLastError() == ERROR_FILE_NOT_FOUND &&
+                MoveFileExW(wideTempFileName.c_str(), wideFileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE);
+#else
+            bool isReplaced = std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+
+            if (isReplaced == true)
+            {
+                // The rename itself is only stored on the disk, when the directory is flushed
+                std::string directoryName = std::filesystem::path(fileName).parent_path().string();
+                int directory = open(directoryName.empty() == true ? "." : directoryName.c_str(), O_RDONLY);
+
+                if (directory >= 0)
+                {
+                    fsync(directory);
+                    close(directory);
+                }
+            }
+#endif
+
+            if (isReplaced == false)
+            {
+                RemoveTempFile(tempFileName);
+            }
+
+            return isReplaced;
+        }
+
+        // The temporary file name is already native, so it isn't converted like the file names of the user
+        static void RemoveTempFile(const std::filesystem::path& tempFileName)
+        {
+            std::error_code errorCode;
+
+            std::filesystem::remove(tempFileName, errorCode);
+        }
+
+        // Zero marks an image with an unknown source
+        static std::uint64_t HashSource(std::string_view sourceContents)
+        {
+            std::uint64_t sourceHash = havUtils::HashBytes(sourceContents);
+
+            return (sourceHash == 0) ? 1 : sourceHash;
+        }
+
+        bool WriteCompiledFile(const std::string& fileName, const basic_havINISnapshot<CasePolicy>& snapshot, std::uint64_t sourceHash)
+        {
+            if (WriteFileAtomically(fileName, snapshot.GetFileImage(sourceHash)) == false)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::WriteFailed, "Unable to write compiled INI file: " + fileName);
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // The file stays mapped as long as the snapshot or one of its copies exists
+        bool MapCompiledFile(const std::string& fileName, std::uint64_t sourceHash, basic_havINISnapshot<CasePolicy>& snapshot)
+        {
+#ifdef _WIN32
+            HANDLE file = CreateFileW(ConvertStringToWString(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER fileSize;
+            HANDLE mapping = nullptr;
+
+            if (GetFileSizeEx(file, &fileSize) != FALSE && fileSize.QuadPart > 0)
+            {
+                mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            }
+
+            CloseHandle(file);
+
+            if (mapping == nullptr)
+            {
+                return false;
+            }
+
+            // The view keeps the mapping alive
+            const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+            CloseHandle(mapping);
+
+            if (view == nullptr)
+            {
+                return false;
+            }
+
+            std::size_t imageSize = static_cast<std::size_t>(fileSize.QuadPart);
+            std::shared_ptr<const char> image(static_cast<const char*>(view), [](const char* data) { UnmapViewOfFile(data); });
+#else
+            int file = open(fileName.c_str(), O_RDONLY);
+
+            if (file < 0)
+            {
+                return false;
+            }
+
+            struct stat fileStatus;
+            void* view = MAP_FAILED;
+
+            if (fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+            {
+                view = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, file, 0);
+            }
+
+            // The mapping keeps the file alive
+            close(file);
+
+            if (view == MAP_FAILED)
+            {
+                return false;
+            }
+
+            std::size_t imageSize = static_cast<std::size_t>(fileStatus.st_size);
+            std::shared_ptr<const char> image(static_cast<const char*>(view), [imageSize](const char* data) { munmap(const_cast<char*>(data), imageSize); });
+#endif
+
+            return snapshot.SetImage(std::move(image), imageSize, sourceHash);
+        }
+
+        // Opens the file and returns its size, a null pointer is returned if the file can't be read or is too small
+        havINIFilePointer OpenFile(const std::string& fileName, std::size_t& fileSize)
+        {
+#ifdef _WIN32
+            havINIFilePointer fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"rb"), std::fclose);
 #else
-                havINIData newComment(mLocale, key, value, havINIDataType::Comment);
+            havINIFilePointer fileStream(std::fopen(fileName.c_str(), "rb"), std::fclose);
 #endif
 
-                std::ptrdiff_t index = 0;
+            if (fileStream == nullptr)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::OpenFailed, "Unable to open INI file: " + fileName);
+
+                return havINIFilePointer(nullptr, std::fclose);
+            }
+
+            // Get file size
+            std::fseek(fileStream.get(), 0, SEEK_END);
+            long endPosition = std::ftell(fileStream.get());
+            std::fseek(fileStream.get(), 0, SEEK_SET);
+
+            if (endPosition < 0)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ReadFailed, "Unable to read INI file: " + fileName);
+
+                return havINIFilePointer(nullptr, std::fclose);
+            }
+
+            if (endPosition == 0)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::EmptyFile, "INI file is empty!");
+
+                return havINIFilePointer(nullptr, std::fclose);
+            }
+
+            if (endPosition < 6)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::FileTooSmall, "INI file cannot be smaller than 6 bytes! (Size in bytes: " + std::to_string(endPosition) + ")");
+
+                return havINIFilePointer(nullptr, std::fclose);
+            }
+
+            fileSize = static_cast<std::size_t>(endPosition);
+
+            return fileStream;
+        }
+
+        bool ReadFile(const std::string& fileName, std::string& fileBuffer)
+        {
+            std::size_t fileSize = 0;
+            havINIFilePointer fileStream = OpenFile(fileName, fileSize);
+
+            if (fileStream == nullptr)
+            {
+                return false;
+            }
+
+            // Read the whole file with a single call, the BOM is skipped by offset afterwards
+            fileBuffer.assign(fileSize, '\0');
+
+            havINIStatsTimer readTimer(GetCollectedParseStats(), &havINIParseStats::readTime);
+            std::size_t fileReadSize = std::fread(&fileBuffer[0], sizeof(char), fileBuffer.size(), fileStream.get());
+            readTimer.Stop();
+
+            if (fileReadSize != fileBuffer.size())
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ReadFailed, "Unable to read INI file: " + fileName);
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // Reads the file in chunks of HAVINI_READ_CHUNK_SIZE bytes and calls blockHandler(block, isLastBlock) with the UTF-8 contents of the complete lines
+        // read so far, until it returns false. A partial line and an incomplete UTF-16/UTF-32 code unit are kept for the next block, so only the longest
+        // line decides how much memory is needed. The last block contains the rest of the file and may be empty.
+        template<class BlockHandler>
+        bool ReadFileInChunks(const std::string& fileName, BlockHandler blockHandler)
+        {
+            std::size_t fileSize = 0;
+            havINIFilePointer fileStream = OpenFile(fileName, fileSize);
+
+            if (fileStream == nullptr)
+            {
+                return false;
+            }
+
+            std::string chunk; // Starts with the bytes of an incomplete code unit of the previous chunk
+            std::string lines; // Starts with the partial line of the previous block
+            std::size_t readSize = 0;
+            havINIBOMType bomType = havINIBOMType::None;
+
+            while (true)
+            {
+                std::size_t carriedSize = chunk.size();
+                std::size_t chunkSize = std::min<std::size_t>(HAVINI_READ_CHUNK_SIZE, fileSize - readSize);
+
+                chunk.resize(carriedSize + chunkSize);
+
+                havINIStatsTimer readTimer(GetCollectedParseStats(), &havINIParseStats::readTime);
+                std::size_t chunkReadSize = std::fread(&chunk[carriedSize], sizeof(char), chunkSize, fileStream.get());
+                readTimer.Stop();
 
-                if (position == havINIPosition::Above || position == havINIPosition::Below)
+                if (chunkReadSize != chunkSize)
                 {
-                    auto foundOtherKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == otherKeyName; } );
+                    Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ReadFailed, "Unable to read INI file: " + fileName);
 
-                    if (foundOtherKeyValuePair != mKeyValuePairs.end())
-                    {
-                        index = GetIndex((*foundOtherKeyValuePair));
-                    }
-                    else
+                    return false;
+                }
+
+                std::size_t decodeStart = 0;
+                bool isLastBlock = (readSize + chunkSize == fileSize);
+
+                if (readSize == 0)
+                {
+                    bomType = DetectEncoding(chunk.data(), chunk.size(), havINIBOMType::None, decodeStart);
+                }
+
+                readSize += chunkSize;
+
+                // Trailing bytes which don't form a complete code unit (or surrogate pair) are decoded with the next chunk
+                std::size_t decodeSize = chunk.size() - decodeStart;
+                bool isUTF16 = (bomType == havINIBOMType::UTF16LE || bomType == havINIBOMType::UTF16BE);
+                bool isUTF32 = (bomType == havINIBOMType::UTF32LE || bomType == havINIBOMType::UTF32BE);
+
+                if (isLastBlock == false && isUTF16 == true)
+                {
+                    decodeSize -= decodeSize % 2;
+
+                    // High byte of the last code unit, a high surrogate needs the low surrogate of the next chunk
+                    unsigned char lastUnit = (decodeSize == 0) ? 0 : static_cast<unsigned char>(chunk[decodeStart + decodeSize - ((bomType == havINIBOMType::UTF16BE) ? 2 : 1)]);
+
+                    if (lastUnit >= 0xd8 && lastUnit <= 0xdb)
                     {
-                        throw std::runtime_error("\"" + otherKeyName.value() + "\" could not be found!");
+                        decodeSize -= 2;
                     }
                 }
+                else if (isLastBlock == false && isUTF32 == true)
+                {
+                    decodeSize -= decodeSize % 4;
+                }
+
+                havINIStatsTimer decodeTimer(GetCollectedParseStats(), &havINIParseStats::decodeTime);
 
-                switch (position)
+                if (isUTF16 == true)
                 {
-                case havINIPosition::Start:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin(), newComment);
-                    break;
+                    lines += havUtils::UTF16ToUTF8(chunk.data() + decodeStart, decodeSize, bomType == havINIBOMType::UTF16BE);
+                }
+                else if (isUTF32 == true)
+                {
+                    lines += havUtils::UTF32ToUTF8(chunk.data() + decodeStart, decodeSize, bomType == havINIBOMType::UTF32BE);
+                }
+                else
+                {
+                    lines.append(chunk, decodeStart, decodeSize);
+                }
 
-                case havINIPosition::Above:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin() + index, newComment);
-                    break;
+                decodeTimer.Stop();
 
-                case havINIPosition::Below:
-                    mKeyValuePairs.insert(mKeyValuePairs.begin() + index + 1, newComment);
-                    break;
+                if (mCollectParseStats == true)
+                {
+                    mParseStats.bytesRead += chunkSize;
+                    mParseStats.peakBufferSize = std::max(mParseStats.peakBufferSize, chunk.size() + lines.size());
+                }
 
-                case havINIPosition::End:
-                default:
-                    mKeyValuePairs.insert(mKeyValuePairs.end(), newComment);
-                    break;
+                chunk.erase(0, decodeStart + decodeSize);
+
+                std::size_t linesSize = lines.size();
+
+                if (isLastBlock == false)
+                {
+                    // A CR at the end might be followed by a LF in the next chunk
+                    std::size_t searchSize = (lines.empty() == false && lines.back() == '\r') ? lines.size() - 1 : lines.size();
+                    std::size_t lineEnd = (searchSize == 0) ? std::string::npos : lines.find_last_of("\r\n", searchSize - 1);
+
+                    linesSize = (lineEnd == std::string::npos) ? 0 : lineEnd + 1;
                 }
 
-                return true;
-            }
+                if (linesSize > 0 || isLastBlock == true)
+                {
+                    if (blockHandler(std::string_view(lines.data(), linesSize), isLastBlock) == false || isLastBlock == true)
+                    {
+                        return true;
+                    }
 
-            return false;
+                    lines.erase(0, linesSize);
+                }
+            }
         }
 
-        void SetKey(std::string key, std::vector<havINIData>::iterator it)
+        // Detects the encoding and converts the data to UTF-8, the contents point either into data or into convertedFileContents
+        bool DecodeBuffer(const void* data, std::size_t size, havINIBOMType bomType, std::string& convertedFileContents, std::string_view& fileContents)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-#endif
+            if (data == nullptr && size > 0)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ReadFailed, "Unable to read INI data!");
 
-            it->SetKey(key);
-        }
+                return false;
+            }
 
-        const std::string& GetSectionName() const { return mSectionName; }
-        std::string GetInlineComment() const
-        {
-            if (HasInlineComment() == false)
+            std::size_t bytesToSkip = 0;
+
+            bomType = DetectEncoding(data, size, bomType, bytesToSkip);
+
+            const char* fileData = static_cast<const char*>(data) + bytesToSkip;
+            std::size_t fileDataSize = size - bytesToSkip;
+            fileContents = std::string_view(fileData, fileDataSize);
+
+            havINIStatsTimer decodeTimer(GetCollectedParseStats(), &havINIParseStats::decodeTime);
+
+            // Convert the file contents to UTF-8, if necessary
+            if (bomType == havINIBOMType::UTF16LE || bomType == havINIBOMType::UTF16BE)
             {
-                return "";
+                convertedFileContents = havUtils::UTF16ToUTF8(fileData, fileDataSize, bomType == havINIBOMType::UTF16BE);
+            }
+            else if (bomType == havINIBOMType::UTF32LE || bomType == havINIBOMType::UTF32BE)
+            {
+                convertedFileContents = havUtils::UTF32ToUTF8(fileData, fileDataSize, bomType == havINIBOMType::UTF32BE);
+            }
+
+            if (bomType != havINIBOMType::None && bomType != havINIBOMType::UTF8)
+            {
+                fileContents = convertedFileContents;
             }
-            return mInlineComment.value();
+
+            if (mCollectParseStats == true)
+            {
+                mParseStats.bytesRead += size;
+                mParseStats.peakBufferSize = std::max(mParseStats.peakBufferSize, size + convertedFileContents.size());
+            }
+
+            return true;
         }
-        const std::vector<havINIData>& GetKeyValuePairs() const { return mKeyValuePairs; } // Read-only
 
-        std::vector<havINIData>::iterator GetKeyValuePair(std::string key)
+        // Returns the encoding of the data (Only the first 4 bytes are looked at) and the size of the BOM, which has to be skipped
+        havINIBOMType DetectEncoding(const void* data, std::size_t size, havINIBOMType bomType, std::size_t& bytesToSkip)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            key = havUtils::ToLower(key, mLocale);
-#endif
+            // Check for BOM (Byte order mark)
+            const unsigned char* bomArray = static_cast<const unsigned char*>(data);
+
+            bytesToSkip = 0;
+            havINIBOMType detectedBOMType = havINIBOMType::None;
+            bool isDetected = false;
+
+            if (size >= 4 && bomArray[0] == 0xff && bomArray[1] == 0xfe &&
+                bomArray[2] == 0x00 && bomArray[3] == 0x00)
+            {
+                detectedBOMType = havINIBOMType::UTF32LE;
+
+                bytesToSkip = 4;
+            }
+            else if (size >= 4 && bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
+                     bomArray[2] == 0xfe && bomArray[3] == 0xff)
+            {
+                detectedBOMType = havINIBOMType::UTF32BE;
+
+                bytesToSkip = 4;
+            }
+            else if (size >= 2 && bomArray[0] == 0xff && bomArray[1] == 0xfe)
+            {
+                detectedBOMType = havINIBOMType::UTF16LE;
+
+                bytesToSkip = 2;
+            }
+            else if (size >= 2 && bomArray[0] == 0xfe && bomArray[1] == 0xff)
+            {
+                detectedBOMType = havINIBOMType::UTF16BE;
+
+                bytesToSkip = 2;
+            }
+            else if (size >= 3 && bomArray[0] == 0xef && bomArray[1] == 0xbb && bomArray[2] == 0xbf)
+            {
+                detectedBOMType = havINIBOMType::UTF8;
+
+                bytesToSkip = 3;
+            }
+
+            // An explicitly specified encoding wins over the detected one, only a matching BOM is skipped
+            if (bomType != havINIBOMType::None)
+            {
+                if (detectedBOMType != bomType)
+                {
+                    bytesToSkip = 0;
+                }
+            }
+            else
+            {
+                bomType = detectedBOMType;
+
+                isDetected = true;
+            }
+
+            // If no BOM has been found, we still need to check for the file encoding
+            if (bomType == havINIBOMType::None && size >= 4)
+            {
+                if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
+                    bomArray[2] == 0x00 && bomArray[3] == 0x00)
+                {
+                    bomType = havINIBOMType::UTF32LE;
+                }
+                else if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
+                         bomArray[2] == 0x00 && bomArray[3] != 0x00)
+                {
+                    bomType = havINIBOMType::UTF32BE;
+                }
+                else if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
+                         bomArray[2] != 0x00 && bomArray[3] == 0x00)
+                {
+                    bomType = havINIBOMType::UTF16LE;
+                }
+                else if (bomArray[0] == 0x00 && bomArray[1] != 0x00 &&
+                         bomArray[2] == 0x00 && bomArray[3] != 0x00)
+                {
+                    bomType = havINIBOMType::UTF16BE;
+                }
+            }
+
+            if (isDetected == true && bomType != havINIBOMType::None)
+            {
+                std::string bomTypeString;
+
+                switch (bomType)
+                {
+                case havINIBOMType::UTF16LE:
+                    bomTypeString = "UTF-16 Little Endian";
+                    break;
 
-            return std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == key; } );
-        }
+                case havINIBOMType::UTF16BE:
+                    bomTypeString = "UTF-16 Big Endian";
+                    break;
 
-        bool HasInlineComment() const { return mInlineComment.has_value(); }
+                case havINIBOMType::UTF32LE:
+                    bomTypeString = "UTF-32 Little Endian";
+                    break;
 
-        bool HasKey(std::string keyName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                case havINIBOMType::UTF32BE:
+                    bomTypeString = "UTF-32 Big Endian";
+                    break;
 
-            return std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == keyName; } ) != mKeyValuePairs.end();
-        }
+                default:
+                    bomTypeString = "UTF-8";
+                    break;
+                }
 
-        std::vector<havINIData>::size_type GetNumberOfKeys() const
-        {
-            return mKeyValuePairs.size();
-        }
+                Report(havINIDiagnosticType::Notice, havINIDiagnosticCode::BOMSkipped, "INI file starts with " + bomTypeString +
+                    " BOM! Please note that by default the BOM will be skipped, and removed in case the INI file gets saved and the BOM was not specified!");
+            }
 
-        void RemoveKeyValuePair(std::vector<havINIData>::iterator it)
-        {
-            mKeyValuePairs.erase(it);
+            return bomType;
         }
 
-        bool RemoveKeyValuePair(std::string keyName)
+        // Collects the characters of a token (section name, key, value). As long as the characters are contiguous
+        // in the line only their position is tracked, they're copied into the buffer once something (e.g. a whitespace) is skipped.
+        class havINIToken
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+            public:
+                explicit havINIToken(std::string& buffer) : mBuffer(buffer)
+                {
+                    mBuffer.clear();
+                }
 
-            auto foundKeyValuePair = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == keyName; } );
+                void Append(std::string_view line, std::size_t index)
+                {
+                    if (mIsCopy == false)
+                    {
+                        if (mSize == 0)
+                        {
+                            mStart = index;
+                            mSize = 1;
 
-            if (foundKeyValuePair != mKeyValuePairs.end())
-            {
-                mKeyValuePairs.erase(foundKeyValuePair);
+                            return;
+                        }
 
-                return true;
-            }
+                        if (mStart + mSize == index)
+                        {
+                            ++mSize;
 
-            return false;
-        }
+                            return;
+                        }
 
-        unsigned int GetCommentLineCount() { return ++mCommentLineCount; }
-        unsigned int GetEmptyLineCount() { return ++mEmptyLineCount; }
+                        mBuffer.assign(line.data() + mStart, mSize);
+                        mIsCopy = true;
+                    }
 
-        std::vector<std::string> GetCommentKeyNames(std::string keyName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                    mBuffer += line[index];
+                }
 
-            std::vector<std::string> commentKeyNames;
+                // Appends count characters starting at index at once
+                void Append(std::string_view line, std::size_t index, std::size_t count)
+                {
+                    if (count == 0)
+                    {
+                        return;
+                    }
 
-            for (const auto& keyValuePair : mKeyValuePairs)
-            {
-                const std::string& key = keyValuePair.GetKey();
+                    if (mIsCopy == false)
+                    {
+                        if (mSize == 0)
+                        {
+                            mStart = index;
+                            mSize = count;
 
-                if (havUtils::StartsWith(key, keyName) == true && keyValuePair.GetType() == havINIDataType::Comment)
-                {
-                    commentKeyNames.emplace_back(key);
-                }
-            }
+                            return;
+                        }
 
-            return commentKeyNames;
-        }
+                        if (mStart + mSize == index)
+                        {
+                            mSize += count;
 
-        bool RemoveComment(std::string keyName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                            return;
+                        }
 
-            auto foundComment = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == keyName && data.GetType() == havINIDataType::Comment; } );
+                        mBuffer.assign(line.data() + mStart, mSize);
+                        mIsCopy = true;
+                    }
 
-            if (foundComment != mKeyValuePairs.end())
-            {
-                mKeyValuePairs.erase(foundComment);
+                    mBuffer.append(line.data() + index, count);
+                }
 
-                return true;
-            }
+                std::string_view View(std::string_view line) const
+                {
+                    if (mIsCopy == true)
+                    {
+                        return mBuffer;
+                    }
 
-            return false;
-        }
+                    return line.substr(mStart, mSize);
+                }
 
-        std::vector<std::string> GetEmptyLineKeyNames(std::string keyName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                bool Empty() const { return mIsCopy == false && mSize == 0; }
 
-            std::vector<std::string> emptyLineKeyNames;
+            private:
+                std::string& mBuffer;
+                std::size_t mStart = 0;
+                std::size_t mSize = 0;
+                bool mIsCopy = false;
+        };
 
-            for (const auto& keyValuePair : mKeyValuePairs)
+        // ASCII whitespaces are found by the scanning kernels, the locale only has to be asked for non-ASCII characters if it treats any of them as whitespace
+        static bool HasNonASCIISpaces(const std::ctype<char>& ctype)
+        {
+            for (int currentChar = 0x80; currentChar <= 0xff; ++currentChar)
             {
-                const std::string& key = keyValuePair.GetKey();
-
-                if (havUtils::StartsWith(key, keyName) == true && keyValuePair.GetType() == havINIDataType::Empty)
+                if (ctype.is(std::ctype_base::space, static_cast<char>(currentChar)) == true)
                 {
-                    emptyLineKeyNames.emplace_back(key);
+                    return true;
                 }
             }
 
-            return emptyLineKeyNames;
+            return false;
         }
 
-        bool RemoveEmptyLine(std::string keyName)
+        // Calls lineHandler(lineStart, line) for every line of the contents until it returns false, escape sequences are decoded into decodedLine
+        // (The lines are passed as they are, if decodedLine is a null pointer)
+        template<class LineHandler>
+        bool ForEachLine(std::string_view contents, std::string* decodedLine, LineHandler lineHandler)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
-
-            auto foundEmptyLine = std::find_if(mKeyValuePairs.begin(), mKeyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == keyName && data.GetType() == havINIDataType::Empty; } );
+            std::size_t lineStart = 0;
 
-            if (foundEmptyLine != mKeyValuePairs.end())
+            while (lineStart < contents.size())
             {
-                mKeyValuePairs.erase(foundEmptyLine);
+                // CRLF, CR and LF are supported as line endings, backslashes are remembered on the way
+                bool hasEscapeSequence = false;
+                std::size_t lineEnd = havUtils::FindNextStructuralCharacter(contents, lineStart, "\r\n\\", false, false);
 
-                return true;
-            }
-
-            return false;
-        }
+                while (lineEnd < contents.size() && contents[lineEnd] == '\\')
+                {
+                    hasEscapeSequence = true;
+                    lineEnd = havUtils::FindNextStructuralCharacter(contents, lineEnd + 1, "\r\n\\", false, false);
+                }
 
-        void Clear()
-        {
-            mInlineComment.reset();
-            mKeyValuePairs.clear();
+                std::size_t nextLineStart = 0;
 
-            mCommentLineCount = 0;
-            mEmptyLineCount = 0;
-        }
+                if (lineEnd == contents.size())
+                {
+                    lineEnd = contents.size();
+                    nextLineStart = lineEnd;
+                }
+                else if (contents[lineEnd] == '\r' && lineEnd + 1 < contents.size() && contents[lineEnd + 1] == '\n')
+                {
+                    nextLineStart = lineEnd + 2;
+                }
+                else
+                {
+                    nextLineStart = lineEnd + 1;
+                }
 
-#ifndef HAVINI_CASE_SENSITIVE
-        const std::locale& GetLocale() const { return mLocale; }
+                std::string_view line = contents.substr(lineStart, lineEnd - lineStart);
 
-        void SetLocale(const std::locale& loc) { mLocale = loc; }
-#endif
+                std::size_t currentLineStart = lineStart;
+                lineStart = nextLineStart;
 
-    private:
-#ifndef HAVINI_CASE_SENSITIVE
-        std::locale mLocale;
-#endif
-        std::string mSectionName;
-        std::optional<std::string> mInlineComment;
-        std::vector<havINIData> mKeyValuePairs;
+                // Escape sequences are the only reason to copy a line
+                if (hasEscapeSequence == true && decodedLine != nullptr)
+                {
+                    decodedLine->clear();
 
-        unsigned int mCommentLineCount;
-        unsigned int mEmptyLineCount;
-    };
+                    DecodeEscapeSequences(line, *decodedLine);
 
-    class havINIStream
-    {
-    public:
-        havINIStream()
-        {
-#ifdef HAVINI_CASE_SENSITIVE
-            mData.emplace_back("HI_Global");
-#else
-            mData.emplace_back(mLocale, "hi_global");
-#endif
-        }
+                    line = *decodedLine;
+                }
 
-        havINISection& operator[](int index)
-        {
-            if (index < 0 || index >= mData.size())
-            {
-                throw std::out_of_range("Index is out of range!");
+                if (lineHandler(currentLineStart, line) == false)
+                {
+                    return false;
+                }
             }
 
-            return mData[index];
+            return true;
         }
 
-        havINISection& operator[](char sectionName)
+        bool IsSectionLine(std::string_view line, const std::ctype<char>& ctype)
         {
-            std::string tempSectionName{ sectionName };
-
-#ifndef HAVINI_CASE_SENSITIVE
-            tempSectionName = havUtils::ToLower(tempSectionName, mLocale);
-#endif
-
-            auto foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == tempSectionName; } );
-
-            if (foundSection == mData.end())
-            {
-#ifdef HAVINI_CASE_SENSITIVE
-                mData.emplace_back(tempSectionName);
-#else
-                mData.emplace_back(mLocale, tempSectionName);
-#endif
-                foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == tempSectionName; } );
-            }
+            std::size_t index = SkipWhitespaces(line, 0, ctype);
 
-            return *foundSection;
+            return index < line.size() && line[index] == '[';
         }
 
-        havINISection& operator[](const char* sectionName)
+        // The block reader calls parseBlock(block, isLastBlock) for consecutive blocks of complete lines until it returns false, see ReadFileInChunks
+        template<class Handler, class BlockReader>
+        havINIParseResult ParseEventsInBlocks(Handler& handler, BlockReader readBlocks)
         {
-            std::string tempSectionName{ sectionName };
+            std::string sectionName = "HI_Global";
+            CasePolicy::Fold(sectionName);
+            std::string errorMessage = "";
 
-#ifndef HAVINI_CASE_SENSITIVE
-            tempSectionName = havUtils::ToLower(tempSectionName, mLocale);
-#endif
+            std::string decodedLine;
+            std::string nameBuffer;
+            std::string valueBuffer;
 
-            auto foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == tempSectionName; } );
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            bool nonASCIISpaces = HasNonASCIISpaces(ctype);
+            bool isParsed = true;
+            std::size_t lineNumber = 0;
 
-            if (foundSection == mData.end())
+            auto parseLine = [&](std::size_t, std::string_view line) -> bool
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mData.emplace_back(tempSectionName);
-#else
-                mData.emplace_back(mLocale, tempSectionName);
-#endif
-                foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == tempSectionName; } );
-            }
+                ++lineNumber;
 
-            return *foundSection;
-        }
+                if (TokenizeLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage, handler) == false)
+                {
+                    return false;
+                }
 
-        havINISection& operator[](std::string sectionName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+                if (mCollectParseStats == true)
+                {
+                    ++mParseStats.lineCount;
+                }
 
-            auto foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == sectionName; } );
+                return true;
+            };
 
-            if (foundSection == mData.end())
+            auto parseBlock = [&](std::string_view block, bool) -> bool
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mData.emplace_back(sectionName);
-#else
-                mData.emplace_back(mLocale, sectionName);
-#endif
-                foundSection = std::find_if(mData.begin(), mData.end(), [&](const havINISection& data) { return data.GetSectionName() == sectionName; } );
-            }
-
-            return *foundSection;
-        }
+                havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
 
-        std::string CodePointToString(const unsigned int codePoint)
-        {
-            // Note: null-terminated string
-            char value[5] = { '\0' };
+                return (isParsed = ForEachLine(block, &decodedLine, parseLine));
+            };
 
-            if (codePoint < 0x80)
-            {
-                value[0] = codePoint;
-            }
-            else if (codePoint < 0x800)
+            if (readBlocks(parseBlock) == false)
             {
-                value[0] = (codePoint >> 6) | 0xc0;
-                value[1] = (codePoint & 0x3f) | 0x80;
+                return havINIParseResult::Failed;
             }
-            else if (codePoint < 0x10000)
+
+            if (isParsed == true)
             {
-                value[0] = (codePoint >> 12) | 0xe0;
-                value[1] = ((codePoint >> 6) & 0x3f) | 0x80;
-                value[2] = (codePoint & 0x3f) | 0x80;
+                return havINIParseResult::Completed;
             }
-            else if (codePoint < 0x110000)
+
+            if (errorMessage.empty() == true)
             {
-                value[0] = (codePoint >> 18) | 0xf0;
-                value[1] = ((codePoint >> 12) & 0x3f) | 0x80;
-                value[2] = ((codePoint >> 6) & 0x3f) | 0x80;
-                value[3] = (codePoint & 0x3f) | 0x80;
+                return havINIParseResult::Stopped;
             }
 
-            return std::string(value);
+            Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, errorMessage, lineNumber);
+
+            return havINIParseResult::Failed;
         }
 
-        std::string ConvertToEscapedString(const std::string& value)
+        bool ParseContents(std::string_view contents)
         {
-            std::string resultValue;
-
-            unsigned int codePoint = 0;
-            int numOfBytes = 0;
-            bool writeAsHex = false;
-
-            for (std::string::size_type index = 0; index < value.size(); ++index)
-            {
-                switch (value[index])
-                {
-                case '"':
-                    resultValue += "\\\"";
-                    break;
-
-                case '\\':
-                    resultValue += "\\\\";
-                    break;
-
-                case '\b':
-                    resultValue += "\\b";
-                    break;
-
-                case '\f':
-                    resultValue += "\\f";
-                    break;
-
-                case '\n':
-                    resultValue += "\\n";
-                    break;
+            return ParseContentsInBlocks([&](auto parseBlock) -> bool { parseBlock(contents, true); return true; });
+        }
 
-                case '\r':
-                    resultValue += "\\r";
-                    break;
+        // The block reader calls parseBlock(block, isLastBlock) for consecutive blocks of complete lines until it returns false, see ReadFileInChunks.
+        // Only a failed read returns false, like ParseContents the parsing stops at the first error.
+        template<class BlockReader>
+        bool ParseContentsInBlocks(BlockReader readBlocks)
+        {
+            std::string sectionName = "HI_Global";
+            CasePolicy::Fold(sectionName);
+            std::string errorMessage = "";
 
-                case '\t':
-                    resultValue += "\\t";
-                    break;
+            // Buffers which are reused for every line, so they only allocate when a line needs more space than the lines before
+            std::string decodedLine;
+            std::string nameBuffer;
+            std::string valueBuffer;
 
-                case '\v':
-                    resultValue += "\\v";
-                    break;
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            bool nonASCIISpaces = HasNonASCIISpaces(ctype);
 
-                default:
-                    {
-                        writeAsHex = false;
-                        codePoint = 0;
+            ParsePendingSections();
 
-                        if ((value[index] & 0x80) == 0x00)
-                        {
-                            numOfBytes = 1;
+            // Sections can only be reloaded one by one, if the stream contains nothing but these contents and every section appears only once
+            bool recordSourceSections = IsEmpty();
+            std::size_t sectionSlot = 0;
 
-                            if (value[index] < 0x1f)
-                            {
-                                writeAsHex = true;
+            // The lines of the current section which were part of earlier blocks are only hashed, so no block is kept
+            havUtils::havINIHasher sectionHasher;
+            std::size_t sectionSize = 0;
+            std::size_t lineNumber = 0;
 
-                                codePoint = (value[index] & 0x7f);
-                            }
-                        }
-                        else if ((value[index] & 0xe0) == 0xc0)
-                        {
-                            numOfBytes = 2;
+            mSourceSections.clear();
+            mSourceSectionsValid = false;
 
-                            writeAsHex = true;
+            auto appendSourceSection = [&](std::string_view blockContents)
+            {
+                sectionHasher.Append(blockContents);
+                sectionSize += blockContents.size();
+            };
 
-                            codePoint = (value[index] & 0x1f);
-                        }
-                        else if ((value[index] & 0xf0) == 0xe0)
-                        {
-                            numOfBytes = 3;
+            auto addSourceSection = [&](std::string_view blockContents)
+            {
+                appendSourceSection(blockContents);
 
-                            writeAsHex = true;
+                mSourceSections.push_back(havINISourceSection{ sectionSlot, sectionSize, sectionHasher.GetHash() });
+                sectionHasher = havUtils::havINIHasher();
+                sectionSize = 0;
 
-                            codePoint = (value[index] & 0x0f);
-                        }
-                        else if ((value[index] & 0xf8) == 0xf0)
-                        {
-                            numOfBytes = 4;
+                // The section is complete, while its key value pairs are still in the cache
+                mData[sectionSlot].ClearChangedSinceParse();
+            };
 
-                            writeAsHex = true;
+            auto parseBlock = [&](std::string_view block, bool isLastBlock) -> bool
+            {
+                havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
+                std::size_t sectionStart = 0;
 
-                            codePoint = (value[index] & 0x07);
-                        }
-                        else
-                        {
-                            throw std::runtime_error("Invalid UTF-8 sequence!");
-                        }
+                bool isParsed = ForEachLine(block, &decodedLine, [&](std::size_t lineStart, std::string_view line) -> bool
+                {
+                    ++lineNumber;
 
-                        for (int byteCount = 1; byteCount < numOfBytes; ++byteCount)
-                        {
-                            if ((value[++index] & 0xc0) != 0x80)
-                            {
-                                throw std::runtime_error("Invalid UTF-8 sequence!");
-                            }
+                    bool isSectionLine = (recordSourceSections == true && IsSectionLine(line, ctype) == true);
 
-                            codePoint = (codePoint << 6) | (value[index] & 0x3f);
-                        }
+                    if (isSectionLine == true)
+                    {
+                        addSourceSection(block.substr(sectionStart, lineStart - sectionStart));
+                        sectionStart = lineStart;
+                    }
 
-                        if (writeAsHex == true)
-                        {
-                            std::ostringstream outputStringStream;
+                    std::size_t sectionCount = mData.size();
 
-                            // Code point is UTF-16 surrogate pair
-                            if (codePoint >= 0x10000 && codePoint <= 0x10ffff)
-                            {
-                                codePoint -= 0x10000;
+                    if (ParseLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage) == false)
+                    {
+                        Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, errorMessage, lineNumber);
 
-                                unsigned int highSurrogate = (codePoint / 0x400) + 0xd800;
-                                unsigned int lowSurrogate = (codePoint % 0x400) + 0xdc00;
+                        return false;
+                    }
 
-                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << highSurrogate;
-                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << lowSurrogate;
+                    if (isSectionLine == true)
+                    {
+                        // A section which appears a second time is merged into the first one
+                        recordSourceSections = (mData.size() > sectionCount);
+                        sectionSlot = mData.size() - 1;
+                    }
 
-                                resultValue += outputStringStream.str();
-                            }
-                            else
-                            {
-                                outputStringStream << "\\x" << std::hex << std::setw(4) << std::setfill('0') << codePoint;
+                    return true;
+                });
 
-                                resultValue += outputStringStream.str();
-                            }
-                        }
-                        else
-                        {
-                            resultValue += static_cast<unsigned int>(value[index]);
-                        }
+                if (isParsed == true && recordSourceSections == true)
+                {
+                    if (isLastBlock == true)
+                    {
+                        addSourceSection(block.substr(sectionStart));
+                        mSourceSectionsValid = true;
+                    }
+                    else
+                    {
+                        appendSourceSection(block.substr(sectionStart));
                     }
-                    break;
                 }
-            }
+                else
+                {
+                    mSourceSections.clear();
+                    recordSourceSections = false;
+                }
 
-            return resultValue;
+                return isParsed;
+            };
+
+            return readBlocks(parseBlock);
         }
 
-        bool ParseFile(const std::string& fileName)
+        // True, if the stream contains nothing but the empty global section
+        bool IsEmpty()
         {
-#ifdef _WIN32
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"rb"), std::fclose);
-#else
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "rb"), std::fclose);
-#endif
+            return mPendingSectionCount == 0 && mData.size() == 1 && mData.front().GetKeyValuePairs().empty() == true && mData.front().GetTrivia().empty() == true;
+        }
 
-            if (fileStream == nullptr)
-            {
-                std::cout << "Unable to open INI file: " << fileName << "\n";
+        // Lazy parsing needs an empty stream, otherwise the lines of a section would have to be merged with its current contents
+        bool CanParseLazily()
+        {
+            return mLazyParsing == true && IsEmpty() == true;
+        }
 
-                return false;
-            }
+        // Only the section headers are parsed, the lines of every section are remembered as ranges of the contents which are parsed on the first access
+        bool ParseLazily(std::string contents, std::size_t contentsStart)
+        {
+            havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
+            std::string errorMessage = "";
 
-            // Get file size
-            std::fseek(fileStream.get(), 0, SEEK_END);
-            long fileSize = std::ftell(fileStream.get());
-            std::fseek(fileStream.get(), 0, SEEK_SET);
+            mSourceSections.clear();
+            mSourceSectionsValid = false;
+            mPendingContents = std::move(contents);
 
-            if (fileSize == 0)
-            {
-                std::cout << "INI file is empty!\n";
+            // The sections are marked as pending at the end, so the headers can still be looked up without parsing a section
+            havINIPendingSlotVector firstRanges(mPendingSections.get_allocator());
 
-                return false;
+            std::size_t errorLine = 0;
+
+            if (FindSectionRanges(std::string_view(mPendingContents).substr(contentsStart), contentsStart, mPendingRanges, firstRanges, errorMessage, errorLine) == false)
+            {
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, errorMessage, errorLine);
             }
 
-            if (fileSize < 6)
+            mPendingSections = std::move(firstRanges);
+            mPendingSectionCount = 0;
+
+            for (std::size_t firstRange : mPendingSections)
             {
-                std::cout << "INI file cannot be smaller than 6 bytes! (Size in bytes: " << fileSize << ")\n";
+                if (firstRange != 0)
+                {
+                    ++mPendingSectionCount;
+                }
+            }
 
-                return false;
+            if (mPendingSectionCount == 0)
+            {
+                ReleasePendingContents();
             }
 
-            unsigned char unsignedCurrentChar;
+            return true;
+        }
 
-            // Check for BOM (Byte order mark)
-            unsigned char bomArray[4] = { '\0' };
+        // Adds the sections of the contents and returns the ranges of their lines, which start with the section header. firstRanges holds the
+        // first range + 1 of every slot in mData (Zero, if there is none) and a section which appears a second time gets a chain of ranges.
+        // Like ParseContents, everything behind an invalid section header is skipped, errorLine is the line number of the header.
+        bool FindSectionRanges(std::string_view contents, std::size_t contentsStart, havINIPendingRangeVector& ranges, havINIPendingSlotVector& firstRanges, std::string& errorMessage, std::size_t& errorLine)
+        {
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-            // Read the first four bytes of the file
-            for (int index = 0; index < 4; ++index)
-            {
-                std::fread(&unsignedCurrentChar, sizeof(unsigned char), 1, fileStream.get());
+            std::string sectionName;
+            std::string decodedLine;
+            std::string nameBuffer;
+            std::string valueBuffer;
 
-                bomArray[index] = unsignedCurrentChar;
-            }
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            bool nonASCIISpaces = HasNonASCIISpaces(ctype);
 
-            int bytesToSkip = 0;
-            int skippedBytes = 0;
-            havINIBOMType bomType = havINIBOMType::None;
+            havINIPendingSlotVector lastRanges(firstRanges.get_allocator());
 
-            if (bomArray[0] == 0xff && bomArray[1] == 0xfe &&
-                bomArray[2] == 0x00 && bomArray[3] == 0x00)
-            {
-                bomType = havINIBOMType::UTF32LE;
+            // The section headers are parsed again with the lines of their sections, so they're left out of the parse stats
+            havINIDocumentHandler handler{ *this, false };
 
-                bytesToSkip = 4;
-            }
-            else if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
-                     bomArray[2] == 0xfe && bomArray[3] == 0xff)
-            {
-                bomType = havINIBOMType::UTF32BE;
+            ranges.clear();
+            firstRanges.clear();
 
-                bytesToSkip = 4;
-            }
-            else if (bomArray[0] == 0xff && bomArray[1] == 0xfe)
-            {
-                bomType = havINIBOMType::UTF16LE;
+            std::size_t sectionStart = 0;
+            std::size_t sectionLine = 1;
+            std::size_t sectionSlot = 0;
+            std::size_t lineNumber = 0;
 
-                bytesToSkip = 2;
-            }
-            else if (bomArray[0] == 0xfe && bomArray[1] == 0xff)
+            auto addRange = [&](std::size_t sectionEnd)
             {
-                bomType = havINIBOMType::UTF16BE;
+                if (sectionEnd == sectionStart)
+                {
+                    return;
+                }
 
-                bytesToSkip = 2;
-            }
-            else if (bomArray[0] == 0xef && bomArray[1] == 0xbb && bomArray[2] == 0xbf)
-            {
-                bomType = havINIBOMType::UTF8;
+                if (sectionSlot >= firstRanges.size())
+                {
+                    firstRanges.resize(sectionSlot + 1, 0);
+                    lastRanges.resize(sectionSlot + 1, 0);
+                }
 
-                bytesToSkip = 3;
-            }
+                ranges.push_back(havINIPendingRange{ contentsStart + sectionStart, sectionEnd - sectionStart, npos, sectionLine });
 
-            // If no BOM has been found, we still need to check for the file encoding
-            if (bomType == havINIBOMType::None)
-            {
-                if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
-                    bomArray[2] == 0x00 && bomArray[3] == 0x00)
+                if (lastRanges[sectionSlot] == 0)
                 {
-                    bomType = havINIBOMType::UTF32LE;
+                    firstRanges[sectionSlot] = ranges.size();
                 }
-                else if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
-                         bomArray[2] == 0x00 && bomArray[3] != 0x00)
+                else
                 {
-                    bomType = havINIBOMType::UTF32BE;
+                    ranges[lastRanges[sectionSlot] - 1].next = ranges.size() - 1;
                 }
-                else if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
-                         bomArray[2] != 0x00 && bomArray[3] == 0x00)
+
+                lastRanges[sectionSlot] = ranges.size();
+            };
+
+            bool isParsed = ForEachLine(contents, nullptr, [&](std::size_t lineStart, std::string_view line) -> bool
+            {
+                ++lineNumber;
+
+                // Escape sequences only have to be decoded, if the line could turn out to be a section header
+                std::size_t index = SkipWhitespaces(line, 0, ctype);
+
+                if (index == line.size() || (line[index] != '[' && line[index] != '\\'))
                 {
-                    bomType = havINIBOMType::UTF16LE;
+                    return true;
                 }
-                else if (bomArray[0] == 0x00 && bomArray[1] != 0x00 &&
-                         bomArray[2] == 0x00 && bomArray[3] != 0x00)
+
+                if (line.find('\\', index) != std::string_view::npos)
                 {
-                    bomType = havINIBOMType::UTF16BE;
+                    decodedLine.clear();
+
+                    DecodeEscapeSequences(line, decodedLine);
+
+                    line = decodedLine;
+
+                    if (IsSectionLine(line, ctype) == false)
+                    {
+                        return true;
+                    }
+                }
+
+                addRange(lineStart);
+                sectionStart = lineStart;
+                sectionLine = lineNumber;
+
+                if (TokenizeLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage, handler) == false)
+                {
+                    errorLine = lineNumber;
+
+                    return false;
                 }
+
+                sectionSlot = FindSectionSlot(sectionName);
+
+                return true;
+            });
+
+            if (isParsed == true)
+            {
+                addRange(contents.size());
             }
 
-            if (bomType != havINIBOMType::None)
+            firstRanges.resize(mData.size(), 0);
+
+            return isParsed;
+        }
+
+        // Number of tasks for parsing the contents in parallel, contents which are added to a stream that isn't empty are parsed on the calling thread
+        std::size_t GetParseTaskCount(std::size_t contentsSize)
+        {
+            if (IsEmpty() == false)
             {
-                std::string bomTypeString;
+                return 1;
+            }
 
-                switch (bomType)
-                {
-                case havINIBOMType::UTF16LE:
-                    bomTypeString = "UTF-16 Little Endian";
-                    break;
+            std::size_t threadCount = (mParseThreadCount == 0) ? std::thread::hardware_concurrency() : mParseThreadCount;
 
-                case havINIBOMType::UTF16BE:
-                    bomTypeString = "UTF-16 Big Endian";
-                    break;
+            return std::max<std::size_t>(std::min<std::size_t>(threadCount, contentsSize / HAVINI_PARALLEL_PARSE_CHUNK_SIZE), 1);
+        }
 
-                case havINIBOMType::UTF32LE:
-                    bomTypeString = "UTF-32 Little Endian";
-                    break;
+        // The section headers are found first, then every task parses a run of consecutive sections into its own stream. The sections are moved into
+        // their slots afterwards, so the document looks exactly like after ParseContents. A section which appears more than once is parsed by the task
+        // which owns its first appearance, all its ranges are parsed in file order.
+        bool ParseInParallel(std::string_view contents, std::size_t taskCount)
+        {
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-                case havINIBOMType::UTF32BE:
-                    bomTypeString = "UTF-32 Big Endian";
-                    break;
+            // The build time of the tasks is part of the tokenize time
+            havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
+            std::string errorMessage = "";
+            std::size_t errorLine = 0;
+            havINIPendingRangeVector ranges(mPendingRanges.get_allocator());
+            havINIPendingSlotVector firstRanges(mPendingSections.get_allocator());
+            bool isSplit = false;
 
-                default:
-                    bomTypeString = "UTF-8";
-                    break;
+            mSourceSections.clear();
+            mSourceSectionsValid = false;
+
+            // Errors are left to ParseContents, so they're reported and handled exactly like before
+            try
+            {
+                isSplit = FindSectionRanges(contents, 0, ranges, firstRanges, errorMessage, errorLine);
+            }
+            catch (const std::exception&)
+            {
+                isSplit = false;
+            }
+
+            // Split the sections into runs of roughly the same size
+            std::vector<std::size_t> taskStarts(1, 0);
+            std::size_t splitSize = 0;
+            bool recordSourceSections = true;
+
+            for (std::size_t slot = 0; slot < mData.size() && isSplit == true; ++slot)
+            {
+                if (slot > taskStarts.back() && splitSize >= contents.size() / taskCount * taskStarts.size())
+                {
+                    taskStarts.push_back(slot);
                 }
 
-                std::cout << "INI file starts with " << bomTypeString << " BOM! Please note that by default the BOM will be skipped, and removed in case the INI file gets saved and the BOM was not specified!\n";
+                for (std::size_t range = firstRanges[slot]; range != 0; range = ranges[range - 1].next + 1)
+                {
+                    splitSize += ranges[range - 1].size;
+
+                    // Sections can only be reloaded one by one, if every section appears only once
+                    recordSourceSections = (recordSourceSections == true && range == firstRanges[slot] && ranges[range - 1].next == npos);
+                }
             }
 
-            std::fseek(fileStream.get(), 0, SEEK_SET);
+            taskStarts.push_back(mData.size());
+
+            std::size_t parsedTaskCount = taskStarts.size() - 1;
+            std::vector<basic_havINIStream> taskStreams;
+            std::vector<std::uint64_t> sectionHashes(mData.size(), 0);
+            std::vector<unsigned char> isTaskParsed(parsedTaskCount, 0);
 
-            std::string fileContents;
-            std::u16string fileContentsU16;
-            std::u32string fileContentsU32;
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            bool nonASCIISpaces = HasNonASCIISpaces(ctype);
 
-            if (bomType == havINIBOMType::None ||
-                bomType == havINIBOMType::UTF8)
+            if (isSplit == true)
             {
-                char currentChar;
-                while (std::fread(&currentChar, sizeof(char), 1, fileStream.get()) > 0)
+                taskStreams.reserve(parsedTaskCount);
+
+                for (std::size_t task = 0; task < parsedTaskCount; ++task)
                 {
-                    if (bytesToSkip > 0)
-                    {
-                        if (skippedBytes < bytesToSkip)
-                        {
-                            ++skippedBytes;
-                            continue;
-                        }
-                    }
-                    fileContents += currentChar;
+                    taskStreams.emplace_back(Allocator(mData.get_allocator()));
+                    taskStreams.back().mKeepComments = mKeepComments;
+                    taskStreams.back().mKeepEmptyLines = mKeepEmptyLines;
+                    taskStreams.back().mKeepInlineComments = mKeepInlineComments;
+                    taskStreams.back().mCollectParseStats = mCollectParseStats;
                 }
             }
-            else if (bomType == havINIBOMType::UTF16LE ||
-                     bomType == havINIBOMType::UTF16BE)
+
+            // Every task only writes to its own stream and to the elements of its own sections
+            std::function<void(std::size_t)> parseTask = [&](std::size_t task)
             {
-                char16_t currentCharU16;
-                while (std::fread(&currentCharU16, sizeof(char16_t), 1, fileStream.get()) > 0)
+                try
                 {
-                    if (bytesToSkip > 0)
+                    basic_havINIStream& taskStream = taskStreams[task];
+                    std::string sectionName;
+                    std::string taskErrorMessage;
+                    std::string decodedLine;
+                    std::string nameBuffer;
+                    std::string valueBuffer;
+
+                    auto parseLine = [&](std::size_t, std::string_view line) -> bool
+                    {
+                        return taskStream.ParseLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, taskErrorMessage);
+                    };
+
+                    for (std::size_t slot = taskStarts[task]; slot < taskStarts[task + 1]; ++slot)
                     {
-                        if (skippedBytes < bytesToSkip)
+                        sectionName.assign(mData[slot].GetSectionName().data(), mData[slot].GetSectionName().size());
+
+                        for (std::size_t range = firstRanges[slot]; range != 0; range = ranges[range - 1].next + 1)
                         {
-                            skippedBytes += sizeof(char16_t);
-                            continue;
+                            std::string_view rangeContents = contents.substr(ranges[range - 1].start, ranges[range - 1].size);
+
+                            if (taskStream.ForEachLine(rangeContents, &decodedLine, parseLine) == false)
+                            {
+                                return;
+                            }
+
+                            if (recordSourceSections == true)
+                            {
+                                sectionHashes[slot] = havUtils::HashBytes(rangeContents);
+                            }
                         }
                     }
-                    fileContentsU16 += currentCharU16;
+
+                    isTaskParsed[task] = 1;
+                }
+                catch (const std::exception&)
+                {
+                    // The error is raised again by ParseContents
                 }
+            };
+
+            if (isSplit == true && mParseExecutor)
+            {
+                mParseExecutor(parsedTaskCount, parseTask);
             }
-            else if (bomType == havINIBOMType::UTF32LE ||
-                     bomType == havINIBOMType::UTF32BE)
+            else if (isSplit == true)
             {
-                char32_t currentCharU32;
-                while (std::fread(&currentCharU32, sizeof(char32_t), 1, fileStream.get()) > 0)
+                std::vector<std::thread> threads;
+                threads.reserve(parsedTaskCount - 1);
+
+                for (std::size_t task = 1; task < parsedTaskCount; ++task)
                 {
-                    if (bytesToSkip > 0)
+                    try
                     {
-                        if (skippedBytes < bytesToSkip)
-                        {
-                            skippedBytes += sizeof(char32_t);
-                            continue;
-                        }
+                        threads.emplace_back(parseTask, task);
+                    }
+                    catch (const std::system_error&)
+                    {
+                        parseTask(task);
                     }
-                    fileContentsU32 += currentCharU32;
+                }
+
+                parseTask(0);
+
+                for (std::thread& thread : threads)
+                {
+                    thread.join();
                 }
             }
 
-            // Convert the file contents to UTF-8, if necessary
-            if (bomType == havINIBOMType::UTF16LE)
+            for (std::size_t task = 0; task < parsedTaskCount && isSplit == true; ++task)
+            {
+                // Besides the global section, a task stream contains the sections of the task in slot order
+                std::size_t sectionCount = taskStarts[task + 1] - taskStarts[task] + ((taskStarts[task] == 0) ? 0 : 1);
+
+                isSplit = (isTaskParsed[task] != 0 && taskStreams[task].mData.size() == sectionCount);
+            }
+
+            if (isSplit == false)
             {
-                fileContents = std::wstring_convert<havINICodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.to_bytes(fileContentsU16);
+                std::string globalSectionName = "HI_Global";
+                CasePolicy::Fold(globalSectionName);
+
+                mData.clear();
+                mSectionIndex.Invalidate();
+
+                mData.emplace_back(globalSectionName);
+                mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
+
+                // The stats of the task streams are dropped, ParseContents counts every line again
+                tokenizeTimer.Stop();
+
+                return ParseContents(contents);
             }
-            else if (bomType == havINIBOMType::UTF16BE)
+
+            for (std::size_t task = 0; task < parsedTaskCount; ++task)
             {
-                std::u16string u16ConvBE;
-                for (char16_t currentChar : fileContentsU16)
+                const havINIParseStats& taskStats = taskStreams[task].mParseStats;
+
+                mParseStats.lineCount += taskStats.lineCount;
+                mParseStats.sectionCount += taskStats.sectionCount;
+                mParseStats.keyCount += taskStats.keyCount;
+                mParseStats.triviaCount += taskStats.triviaCount;
+
+                std::size_t taskSlot = (taskStarts[task] == 0) ? 0 : 1;
+
+                for (std::size_t slot = taskStarts[task]; slot < taskStarts[task + 1]; ++slot)
                 {
-                    u16ConvBE += (((currentChar & 0x00ff) << 8) | ((currentChar & 0xff00) >> 8));
+                    mData[slot] = std::move(taskStreams[task].mData[taskSlot++]);
                 }
-                fileContents = std::wstring_convert<havINICodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.to_bytes(u16ConvBE);
             }
-            else if (bomType == havINIBOMType::UTF32LE)
+
+            if (recordSourceSections == true)
             {
-                fileContents = std::wstring_convert<havINICodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.to_bytes(fileContentsU32);
+                for (std::size_t slot = 0; slot < mData.size(); ++slot)
+                {
+                    std::size_t sectionSize = (firstRanges[slot] == 0) ? 0 : ranges[firstRanges[slot] - 1].size;
+                    std::uint64_t sectionHash = (firstRanges[slot] == 0) ? havUtils::HashBytes(std::string_view()) : sectionHashes[slot];
+
+                    mSourceSections.push_back(havINISourceSection{ slot, sectionSize, sectionHash });
+                }
+
+                mSourceSectionsValid = true;
+
+                ClearChangedSinceParse();
             }
-            else if (bomType == havINIBOMType::UTF32BE)
+
+            return true;
+        }
+
+        // Called when the sections match the recorded source sections
+        void ClearChangedSinceParse()
+        {
+            for (havINISection& section : mData)
             {
-                std::u32string u32ConvBE;
-                for (char32_t currentChar : fileContentsU32)
-                {
-                    u32ConvBE += (((currentChar & 0x000000ff) << 24) |
-                                  ((currentChar & 0x0000ff00) << 8) |
-                                  ((currentChar & 0x00ff0000) >> 8) |
-                                  ((currentChar & 0xff000000) >> 24));
-                }
-                fileContents = std::wstring_convert<havINICodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.to_bytes(u32ConvBE);
+                section.ClearChangedSinceParse();
             }
+        }
+
+        bool IsSectionPending(std::size_t slot) const
+        {
+            return slot < mPendingSections.size() && mPendingSections[slot] != 0;
+        }
 
-            std::vector<std::string> buffer;
+        void ParsePendingSection(std::size_t slot)
+        {
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-            std::string line = "";
+            // The flag is cleared first, because the section header at the beginning of a range looks the section up again
+            std::size_t range = mPendingSections[slot] - 1;
+            mPendingSections[slot] = 0;
 
-            // Read INI file contents
-            for (std::string::size_type index = 0; index < fileContents.size(); ++index)
-            {
-                char currentChar = fileContents[index];
+            std::string sectionName(std::string_view(mData[slot].GetSectionName()));
+            std::string errorMessage = "";
+            std::string decodedLine;
+            std::string nameBuffer;
+            std::string valueBuffer;
+
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            bool nonASCIISpaces = HasNonASCIISpaces(ctype);
 
-                int extractedCharacter = currentChar;
+            // The section counts as parsed on every path, also if an allocation fails
+            struct havINIPendingSectionGuard
+            {
+                basic_havINIStream& stream;
 
-                switch (extractedCharacter)
+                ~havINIPendingSectionGuard()
                 {
-                case '\r':
+                    if (--stream.mPendingSectionCount == 0)
                     {
-                        if (++index >= fileContents.size())
-                        {
-                            break;
-                        }
-
-                        currentChar = fileContents[index + 1];
+                        stream.ReleasePendingContents();
+                    }
+                }
+            };
 
-                        // CRLF found!
-                        if (currentChar == '\n')
-                        {
-                            extractedCharacter = currentChar;
+            havINIPendingSectionGuard pendingSectionGuard{ *this };
 
-                            line += static_cast<char>(extractedCharacter);
-                            buffer.push_back(line);
-                            line.clear();
-                        }
-                        // CR found!
-                        else
-                        {
-                            line += '\n';
-                            buffer.push_back(line);
-                            line.clear();
-                        }
-                    }
-                    break;
+            // Added to the stats of the last parse call, which skipped the section
+            havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
 
-                case '\n':
-                    // LF found!
-                    line += static_cast<char>(extractedCharacter);
-                    buffer.push_back(line);
-                    line.clear();
-                    break;
+            std::size_t lineNumber = 0;
 
-                case '\\':
-                    {
-                        if (++index >= fileContents.size())
-                        {
-                            break;
-                        }
+            try
+            {
+                bool isParsed = true;
 
-                        currentChar = fileContents[index];
+                // Like ParseContents, the lines behind an error are skipped
+                for (; range != npos && isParsed == true; range = mPendingRanges[range].next)
+                {
+                    std::string_view rangeContents = std::string_view(mPendingContents).substr(mPendingRanges[range].start, mPendingRanges[range].size);
+                    lineNumber = mPendingRanges[range].line;
 
-                        switch (currentChar)
+                    // The line number is only advanced behind a line, so it's also right if decoding the line throws
+                    isParsed = ForEachLine(rangeContents, &decodedLine, [&](std::size_t, std::string_view line) -> bool
+                    {
+                        if (ParseLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage) == false)
                         {
-                        case 'x':
-                            {
-                                std::locale loc;
-
-                                std::string hexString;
-
-                                bool isUnicodeEscapeSequence = false;
-
-                                for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
-                                {
-                                    if (++index >= fileContents.size())
-                                    {
-                                        throw std::runtime_error("Read beyond end of file, and found invalid unicode escape sequence!");
-                                    }
-
-                                    char currentCharInLoop = fileContents[index];
-
-                                    if (std::isxdigit(currentCharInLoop, loc) == false)
-                                    {
-                                        isUnicodeEscapeSequence = false;
-
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        isUnicodeEscapeSequence = true;
-                                    }
-
-                                    hexString += currentCharInLoop;
-                                }
-
-                                if (isUnicodeEscapeSequence == true)
-                                {
-                                    unsigned int codePoint = std::strtol(hexString.c_str(), nullptr, 16);
-
-                                    bool endOfFileReached = false;
-
-                                    if (++index >= fileContents.size())
-                                    {
-                                        endOfFileReached = true;
-                                    }
-
-                                    if (fileContents[index] == '\\' && endOfFileReached == false)
-                                    {
-                                        if (++index >= fileContents.size())
-                                        {
-                                            endOfFileReached = true;
-                                        }
-
-                                        if (fileContents[index] == 'x' && endOfFileReached == false)
-                                        {
-                                            bool surrogatePair = false;
-
-                                            hexString = "";
-
-                                            for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
-                                            {
-                                                if (++index >= fileContents.size())
-                                                {
-                                                    throw std::runtime_error("Read beyond end of file, and found invalid unicode escape sequence!");
-                                                }
-
-                                                char currentCharInLoop = fileContents[index];
-
-                                                if (std::isxdigit(currentCharInLoop, loc) == false)
-                                                {
-                                                    surrogatePair = false;
-
-                                                    break;
-                                                }
-                                                else
-                                                {
-                                                    surrogatePair = true;
-                                                }
-
-                                                hexString += currentCharInLoop;
-                                            }
-
-                                            if (surrogatePair == true)
-                                            {
-                                                if (codePoint >= 0xd800 && codePoint <= 0xdbff)
-                                                {
-                                                    unsigned int secondCodePoint = std::strtol(hexString.c_str(), nullptr, 16);
-
-                                                    if (secondCodePoint >= 0xdc00 && secondCodePoint <= 0xdfff)
-                                                    {
-                                                        // codePoint = high surrogate, secondCodePoint = low surrogate
-                                                        unsigned int surrogatePairValue = 0x10000 + ((codePoint - 0xd800) * 0x400) + (secondCodePoint - 0xdc00);
-
-                                                        line += CodePointToString(surrogatePairValue);
-                                                    }
-                                                    else
-                                                    {
-                                                        throw std::runtime_error("Invalid code point range for UTF-16 low surrogate pair!");
-                                                    }
-                                                }
-                                                else
-                                                {
-                                                    // Set the index back by six characters, otherwise the possible next UTF-8 sequence isn't processed!
-                                                    index -= 6;
-
-                                                    line += CodePointToString(codePoint);
-                                                }
-                                            }
-                                            else
-                                            {
-                                                throw std::runtime_error("Invalid code point for UTF-16 low surrogate pair!");
-                                            }
-                                        }
-                                        else
-                                        {
-                                            // Set the index back by two characters, otherwise the next characters aren't processed!
-                                            index -= 2;
-
-                                            line += CodePointToString(codePoint);
-                                        }
-                                    }
-                                    else
-                                    {
-                                        // Set the index back by one character, otherwise the next character isn't processed!
-                                        --index;
-
-                                        line += CodePointToString(codePoint);
-                                    }
-                                }
-                                else
-                                {
-                                    // Set the index back by one character, otherwise the next character isn't processed!
-                                    --index;
-
-                                    // Don't eat the x character
-                                    line += currentChar;
-
-                                    if (hexString.empty() == false)
-                                    {
-                                        line += hexString;
-                                    }
-                                }
-                            }
-                            break;
+                            Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, errorMessage, lineNumber);
 
-                        default:
-                            throw std::runtime_error("Invalid escape character!");
-                            break;
+                            return false;
                         }
-                    }
-                    break;
 
-                default:
-                    line += static_cast<char>(extractedCharacter);
-                    break;
+                        ++lineNumber;
+
+                        return true;
+                    });
                 }
             }
+            catch (const std::runtime_error& ex)
+            {
+                // Sections are parsed on their first access, so an invalid escape sequence is reported instead of being thrown from a lookup
+                Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, ex.what(), lineNumber);
+            }
+        }
 
-            if (line.empty() == false)
+        void ParsePendingSections()
+        {
+            for (std::size_t slot = 0; slot < mPendingSections.size() && mPendingSectionCount > 0; ++slot)
             {
-                line += '\n';
-                buffer.push_back(line);
-                line.clear();
+                if (mPendingSections[slot] != 0)
+                {
+                    ParsePendingSection(slot);
+                }
             }
+        }
 
-            line.clear();
+        void ReleasePendingContents()
+        {
+            std::string().swap(mPendingContents);
+            havINIPendingRangeVector(mPendingRanges.get_allocator()).swap(mPendingRanges);
+            havINIPendingSlotVector(mPendingSections.get_allocator()).swap(mPendingSections);
+        }
 
-            std::string errorMessage = "";
-#ifdef HAVINI_CASE_SENSITIVE
-            std::string sectionName = "HI_Global";
-#else
-            std::string sectionName = "hi_global";
-#endif
-            std::string keyName = "";
-            std::string value = "";
-            std::string inlineComment = "";
+        bool ReloadBuffer(const void* data, std::size_t size, havINIChangeSet& changes)
+        {
+            std::string convertedFileContents;
+            std::string_view fileContents;
 
-            bool newSection = false;
-            bool newKey = true;
-            bool newValue = false;
-            bool hasInlineComment = false;
+            if (DecodeBuffer(data, size, havINIBOMType::None, convertedFileContents, fileContents) == false)
+            {
+                return false;
+            }
 
-            bool stringValue = false;
+            ReloadContents(fileContents, changes);
 
-            std::string arrayIndex = "";
+            return true;
+        }
 
-            bool isArrayKey = false;
-            bool hasArrayIndex = false;
+        void ReloadContents(std::string_view contents, havINIChangeSet& changes)
+        {
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-            // Parse INI file contents
-            for (std::vector<std::string>::size_type lineIndex = 0; lineIndex < buffer.size(); ++lineIndex)
-            {
-                if (errorMessage.empty() == false)
-                {
-                    std::cout << "Error while reading INI file: " << errorMessage << std::endl;
+            auto sectionNameOf = [](const havINISection& section) -> std::string_view { return section.GetSectionName(); };
 
-                    errorMessage.clear();
+            // The old document is compared completely
+            ParsePendingSections();
 
-                    break;
-                }
+            havINISectionVector oldData(std::move(mData));
+            havINIHashIndex<CasePolicy, Allocator> oldSectionIndex(std::move(mSectionIndex));
+            havINISourceSectionVector oldSourceSections(std::move(mSourceSections));
+            bool reuseSections = mSourceSectionsValid;
 
-                line = buffer[lineIndex];
+            mData.clear();
+            mSectionIndex.Invalidate();
+            mSourceSections.clear();
+            mSourceSectionsValid = false;
 
-                // Remove whitespaces
-                std::size_t characterIndex = 0;
+            std::string globalSectionName = "HI_Global";
+            CasePolicy::Fold(globalSectionName);
 
-                std::string tmpLine = "";
+            const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(mLocale);
+            std::string decodedLine;
 
-                bool commentSection = false;
-                bool valueSection = false;
+            // Slot in oldData of every section in mData which was taken over unchanged
+            std::vector<std::size_t> reusedSlots;
+            std::vector<bool> isReused(oldData.size(), false);
+
+            if (reuseSections == true)
+            {
+                havINIStatsTimer tokenizeTimer(GetCollectedParseStats(), &havINIParseStats::tokenizeTime);
 
-                for (std::size_t cIndex = 0; cIndex < line.size(); ++cIndex)
+                struct havINISectionRange
                 {
-                    if (line[cIndex] == ';' || line[cIndex] == '#')
-                    {
-                        commentSection = true;
-                    }
+                    std::size_t start;
+                    std::size_t size;
+                    std::uint64_t hash;
+                    std::size_t oldSlot; // Slot in oldData, if the section didn't change
+                    std::size_t line; // Line number of the first line
+                };
+
+                // Boundaries and hashes of the new sections in file order
+                std::vector<havINISectionRange> newSections;
+                std::size_t sectionStart = 0;
+                std::size_t sectionLine = 1;
+                std::size_t lineNumber = 0;
+
+                ForEachLine(contents, &decodedLine, [&](std::size_t lineStart, std::string_view line) -> bool
+                {
+                    ++lineNumber;
 
-                    if (line[cIndex] == '\"' || line[cIndex] == '\'')
+                    if (IsSectionLine(line, ctype) == true)
                     {
-                        valueSection = !valueSection;
+                        newSections.push_back(havINISectionRange{ sectionStart, lineStart - sectionStart, havUtils::HashBytes(contents.substr(sectionStart, lineStart - sectionStart)), npos, sectionLine });
+                        sectionStart = lineStart;
+                        sectionLine = lineNumber;
                     }
 
-                    if (commentSection == false && valueSection == false)
+                    return true;
+                });
+
+                newSections.push_back(havINISectionRange{ sectionStart, contents.size() - sectionStart, havUtils::HashBytes(contents.substr(sectionStart)), npos, sectionLine });
+
+                // Sections usually keep their order, so the search for an unchanged section starts behind the last one
+                std::size_t nextOldSection = 0;
+
+                for (std::size_t newSection = 0; newSection < newSections.size(); ++newSection)
+                {
+                    havINISectionRange& range = newSections[newSection];
+
+                    for (std::size_t offset = 0; offset < oldSourceSections.size(); ++offset)
                     {
-                        if (std::isspace(line[cIndex], mLocale) == false)
+                        std::size_t oldSection = (nextOldSection + offset) % oldSourceSections.size();
+                        const havINISourceSection& oldSource = oldSourceSections[oldSection];
+
+                        // The contents before the first section always belong to the global section. A section which was edited since it
+                        // was parsed doesn't match its source anymore, so it is parsed again.
+                        if (oldSource.hash == range.hash && oldSource.size == range.size && (oldSource.slot == 0) == (newSection == 0) &&
+                            oldSource.slot < oldData.size() && isReused[oldSource.slot] == false && oldData[oldSource.slot].IsChangedSinceParse() == false)
                         {
-                            tmpLine += line[cIndex];
+                            range.oldSlot = oldSource.slot;
+                            isReused[oldSource.slot] = true;
+                            nextOldSection = oldSection + 1;
+                            break;
                         }
                     }
-                    else
-                    {
-                        tmpLine += line[cIndex];
-                    }
                 }
 
-                // Empty line
-                if (tmpLine.empty() == true)
-                {
-#ifdef HAVINI_CASE_SENSITIVE
-                    std::string emptyLineKeyStart = "HI_EL_";
-#else
-                    std::string emptyLineKeyStart = "hi_el_";
-#endif
+                // The changed sections are parsed first, so they can't be merged into a section which is taken over
+                std::string sectionName;
+                std::string errorMessage = "";
+                std::string nameBuffer;
+                std::string valueBuffer;
+                bool nonASCIISpaces = HasNonASCIISpaces(ctype);
 
-                    if (HasSection(sectionName) == false)
-                    {
-#ifdef HAVINI_CASE_SENSITIVE
-                        havINISection newSectionForEmptyLine(sectionName);
-#else
-                        havINISection newSectionForEmptyLine(mLocale, sectionName);
-#endif
-                        unsigned int emptyLineCount = newSectionForEmptyLine.GetEmptyLineCount();
-                        newSectionForEmptyLine.SetEmptyLine(emptyLineKeyStart + std::to_string(emptyLineCount), havINIPosition::End);
-                        mData.push_back(newSectionForEmptyLine);
-                    }
-                    else
+                // The error is only reported once the sections are taken over, otherwise ParseContents reports it again
+                std::size_t errorLine = 0;
+
+                auto parseLine = [&](std::size_t, std::string_view line) -> bool
+                {
+                    if (ParseLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage) == false)
                     {
-                        unsigned int emptyLineCount = GetSection(sectionName)->GetEmptyLineCount();
-                        GetSection(sectionName)->SetEmptyLine(emptyLineKeyStart + std::to_string(emptyLineCount), havINIPosition::End);
+                        errorLine = lineNumber;
+
+                        return false;
                     }
 
-                    continue;
-                }
+                    ++lineNumber;
 
-                line = tmpLine;
+                    return true;
+                };
 
-                if (line.back() != '\n')
-                {
-                    line += '\n';
-                }
+                std::size_t sectionCount = newSections.size();
 
-                // Comment
-                if (line[0] == ';' || line[0] == '#')
+                for (std::size_t newSection = 0; newSection < newSections.size() && reuseSections == true; ++newSection)
                 {
-                    // Remove comment character
-                    if (line.front() == ';' || line.front() == '#')
-                    {
-                        line.erase(line.begin());
-                    }
+                    const havINISectionRange& range = newSections[newSection];
 
-                    // Remove potential space character
-                    if (line.front() == ' ')
+                    if (range.oldSlot != npos)
                     {
-                        line.erase(line.begin());
+                        continue;
                     }
 
-                    // Remove LF
-                    if (line.back() == '\n')
+                    std::size_t parsedCount = mData.size();
+
+                    sectionName = globalSectionName;
+
+                    if (newSection == 0)
                     {
-                        line.pop_back();
+                        GetOrAddSection(sectionName);
                     }
 
-#ifdef HAVINI_CASE_SENSITIVE
-                    std::string commentKeyStart = "HI_C_";
-#else
-                    std::string commentKeyStart = "hi_c_";
-#endif
+                    lineNumber = range.line;
 
-                    if (HasSection(sectionName) == false)
+                    bool isParsed = ForEachLine(contents.substr(range.start, range.size), &decodedLine, parseLine);
+
+                    if (isParsed == false && mData.size() == parsedCount)
                     {
-#ifdef HAVINI_CASE_SENSITIVE
-                        havINISection newSectionForComment(sectionName);
-#else
-                        havINISection newSectionForComment(mLocale, sectionName);
-#endif
-                        unsigned int commentLineCount = newSectionForComment.GetCommentLineCount();
-                        newSectionForComment.SetComment(commentKeyStart + std::to_string(commentLineCount), line, havINIPosition::End);
-                        mData.push_back(newSectionForComment);
+                        // Like ParseContents, everything behind an error is skipped
+                        sectionCount = newSection;
+                        break;
                     }
-                    else
+
+                    // Every section must appear only once, otherwise the sections would have to be merged
+                    if (mData.size() != parsedCount + 1)
                     {
-                        unsigned int commentLineCount = GetSection(sectionName)->GetCommentLineCount();
-                        GetSection(sectionName)->SetComment(commentKeyStart + std::to_string(commentLineCount), line, havINIPosition::End);
+                        reuseSections = false;
+                        break;
                     }
 
-                    continue;
+                    if (isParsed == false)
+                    {
+                        sectionCount = newSection + 1;
+                        break;
+                    }
                 }
 
-                // Section
-                if (line[0] == '[')
+                for (std::size_t newSection = 0; newSection < sectionCount && reuseSections == true; ++newSection)
                 {
-                    newSection = true;
-                    newKey = false;
-                    newValue = false;
+                    if (newSections[newSection].oldSlot != npos && FindSection(oldData[newSections[newSection].oldSlot].GetSectionName()) != mData.end())
+                    {
+                        reuseSections = false;
+                    }
+                }
 
-                    stringValue = false;
+                if (reuseSections == true)
+                {
+                    if (errorLine != 0)
+                    {
+                        Report(havINIDiagnosticType::Error, havINIDiagnosticCode::ParseError, errorMessage, errorLine);
+                    }
 
-                    sectionName.clear();
+                    // Merge the parsed and the unchanged sections in file order
+                    havINISectionVector parsedData(std::move(mData));
+                    std::size_t parsedSlot = 0;
 
-                    characterIndex = 0;
+                    mData.clear();
+                    mData.reserve(sectionCount);
+                    mSectionIndex.Invalidate();
 
-                    while (line[characterIndex] != '\n')
+                    for (std::size_t newSection = 0; newSection < sectionCount; ++newSection)
                     {
-                        if (line[characterIndex] == '[' && characterIndex > 0)
-                        {
-                            errorMessage += "New section started within section tag!\n";
-                            break;
-                        }
+                        const havINISectionRange& range = newSections[newSection];
 
-                        if (line[characterIndex] == '[')
+                        if (range.oldSlot != npos)
                         {
-                            ++characterIndex;
-
-                            continue;
+                            mData.push_back(std::move(oldData[range.oldSlot]));
                         }
-
-                        if (line[characterIndex] == ' ')
+                        else
                         {
-                            ++characterIndex;
-
-                            continue;
+                            mData.push_back(std::move(parsedData[parsedSlot++]));
                         }
 
-                        if (line[characterIndex] == ']')
-                        {
-                            newSection = false;
+                        reusedSlots.push_back(range.oldSlot);
 
-                            ++characterIndex;
+                        mSourceSections.push_back(havINISourceSection{ mData.size() - 1, range.size, range.hash });
+                    }
 
-                            continue;
+                    // Unchanged sections behind an error are dropped, they're compared like removed sections
+                    for (std::size_t newSection = sectionCount; newSection < newSections.size(); ++newSection)
+                    {
+                        if (newSections[newSection].oldSlot != npos)
+                        {
+                            isReused[newSections[newSection].oldSlot] = false;
                         }
+                    }
+
+                    mSourceSectionsValid = (sectionCount == newSections.size());
 
-                        if (line[characterIndex] == ';' || line[characterIndex] == '#')
+                    // The sections which were taken over are known to be unchanged
+                    for (std::size_t slot = 0; slot < mData.size(); ++slot)
+                    {
+                        if (reusedSlots[slot] == npos)
                         {
-                            if (newSection == true)
-                            {
-                                errorMessage += "Found comment tag within section tag!\n";
-                                break;
-                            }
-                            else
-                            {
-                                // Section inline comment
-                                std::string sectionInlineComment = "";
+                            mData[slot].ClearChangedSinceParse();
+                        }
+                    }
+                }
+                else
+                {
+                    std::fill(isReused.begin(), isReused.end(), false);
+                }
+            }
 
-                                ++characterIndex;
+            if (reuseSections == false)
+            {
+                // Nothing was taken over from the old sections, everything is parsed again
+                mData.clear();
+                mSectionIndex.Invalidate();
+                mSourceSections.clear();
 
-                                while (line[characterIndex] != '\n')
-                                {
-                                    sectionInlineComment += line[characterIndex];
-                                    ++characterIndex;
-                                }
+                mData.emplace_back(globalSectionName);
+                mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
 
-                                // Remove potential space character
-                                if (sectionInlineComment.empty() == false && sectionInlineComment.front() == ' ')
-                                {
-                                    sectionInlineComment.erase(sectionInlineComment.begin());
-                                }
+                ParseContents(contents);
+            }
 
-#ifndef HAVINI_CASE_SENSITIVE
-                                sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            // Sections which were taken over are unchanged, all others are compared key by key
+            std::vector<bool> isCompared(oldData.size(), false);
 
-                                if (HasSection(sectionName) == false)
-                                {
-#ifdef HAVINI_CASE_SENSITIVE
-                                    havINISection newSectionForInlineComment(sectionName);
-#else
-                                    havINISection newSectionForInlineComment(mLocale, sectionName);
-#endif
-                                    newSectionForInlineComment.SetInlineComment(sectionInlineComment);
-                                    mData.push_back(newSectionForInlineComment);
-                                }
-                                else
-                                {
-                                    GetSection(sectionName)->SetInlineComment(sectionInlineComment);
-                                }
-
-                                // Break the loop now... section creation must be done at this point
-                                break;
-                            }
-                        }
+            for (std::size_t slot = 0; slot < mData.size(); ++slot)
+            {
+                if (slot < reusedSlots.size() && reusedSlots[slot] != npos)
+                {
+                    continue;
+                }
 
-                        sectionName += line[characterIndex];
+                havINISection& newSection = mData[slot];
 
-                        ++characterIndex;
-                    }
+                std::size_t oldSlot = oldSectionIndex.Find(newSection.GetSectionName(), oldData, sectionNameOf);
 
-                    if (newSection == true)
-                    {
-                        errorMessage += "Section end tag was not found!\n";
-                    }
+                if (oldSlot != npos && isReused[oldSlot] == true)
+                {
+                    // The moved-from section doesn't have a name anymore, so a section with an empty name can be found by mistake
+                    oldSlot = npos;
 
-                    if (errorMessage.empty() == true)
+                    for (std::size_t currentSlot = 0; currentSlot < oldData.size(); ++currentSlot)
                     {
-                        // Prepare to read first key-value pair
-                        newKey = true;
+                        if (isReused[currentSlot] == false && CasePolicy::Equal(oldData[currentSlot].GetSectionName(), newSection.GetSectionName()) == true)
+                        {
+                            oldSlot = currentSlot;
+                            break;
+                        }
                     }
+                }
 
-#ifndef HAVINI_CASE_SENSITIVE
-                    sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+                if (oldSlot == npos)
+                {
+                    AddChanges(havINIChangeType::Added, newSection, changes);
+                }
+                else
+                {
+                    AddChanges(oldData[oldSlot], newSection, changes);
 
-                    continue;
+                    isCompared[oldSlot] = true;
                 }
+            }
 
-                if (newKey == true)
+            for (std::size_t oldSlot = 0; oldSlot < oldData.size(); ++oldSlot)
+            {
+                if (isReused[oldSlot] == false && isCompared[oldSlot] == false)
                 {
-                    keyName.clear();
+                    AddChanges(havINIChangeType::Removed, oldData[oldSlot], changes);
+                }
+            }
+        }
 
-                    std::size_t foundCharacter = line.find("=");
-                    std::size_t foundCharacter2 = line.find(":");
+        // A whole section was added or removed
+        void AddChanges(havINIChangeType changeType, havINISection& section, havINIChangeSet& changes)
+        {
+            changes.push_back(havINIChange{ changeType, std::string(section.GetSectionName()), std::string() });
 
-                    if (foundCharacter == std::string::npos && foundCharacter2 == std::string::npos)
-                    {
-                        errorMessage += "No \"=\" or \":\" sign found!\n";
-                    }
+            for (const havINIData& keyValuePair : section.GetKeyValuePairs())
+            {
+                if (keyValuePair.GetType() == havINIDataType::Value || keyValuePair.GetType() == havINIDataType::Array)
+                {
+                    changes.push_back(havINIChange{ changeType, std::string(section.GetSectionName()), std::string(keyValuePair.GetKey()) });
+                }
+            }
+        }
 
-                    char endCharacter = '\0';
+        void AddChanges(havINISection& oldSection, havINISection& newSection, havINIChangeSet& changes)
+        {
+            for (const havINIData& keyValuePair : newSection.GetKeyValuePairs())
+            {
+                if (keyValuePair.GetType() != havINIDataType::Value && keyValuePair.GetType() != havINIDataType::Array)
+                {
+                    continue;
+                }
 
-                    if (foundCharacter != std::string::npos && foundCharacter2 != std::string::npos)
-                    {
-                        if (foundCharacter > foundCharacter2)
-                        {
-                            endCharacter = ':';
-                        }
-                        else
-                        {
-                            endCharacter = '=';
-                        }
-                    }
-                    else
-                    {
-                        if (foundCharacter != std::string::npos)
-                        {
-                            endCharacter = '=';
-                        }
+                auto oldKeyValuePair = oldSection.FindKeyValuePair(keyValuePair.GetKey());
 
-                        if (foundCharacter2 != std::string::npos)
-                        {
-                            endCharacter = ':';
-                        }
-                    }
+                if (oldKeyValuePair == oldSection.GetKeyValuePairs().end())
+                {
+                    changes.push_back(havINIChange{ havINIChangeType::Added, std::string(newSection.GetSectionName()), std::string(keyValuePair.GetKey()) });
+                }
+                else if ((*oldKeyValuePair == keyValuePair) == false)
+                {
+                    changes.push_back(havINIChange{ havINIChangeType::Changed, std::string(newSection.GetSectionName()), std::string(keyValuePair.GetKey()) });
+                }
+            }
 
-                    if (errorMessage.empty() == true)
-                    {
-                        std::string delimiter{ endCharacter };
-                        std::string fullKey(havUtils::Split(line, delimiter)[0]);
+            for (const havINIData& keyValuePair : oldSection.GetKeyValuePairs())
+            {
+                if (keyValuePair.GetType() != havINIDataType::Value && keyValuePair.GetType() != havINIDataType::Array)
+                {
+                    continue;
+                }
 
-                        isArrayKey = false;
-                        hasArrayIndex = false;
+                if (newSection.FindKeyValuePair(keyValuePair.GetKey()) == newSection.GetKeyValuePairs().end())
+                {
+                    changes.push_back(havINIChange{ havINIChangeType::Removed, std::string(newSection.GetSectionName()), std::string(keyValuePair.GetKey()) });
+                }
+            }
+        }
 
-                        if (havUtils::EndsWith(fullKey, "[]") == true)
-                        {
-                            isArrayKey = true;
-                        }
-                        else if (havUtils::StartsWith(fullKey, "[") == false && havUtils::EndsWith(fullKey, "]") == true && fullKey.find("[") != std::string::npos)
-                        {
-                            arrayIndex = havUtils::Split(fullKey, "[")[1];
-                            arrayIndex.pop_back(); // Remove "]" character
+        void DecodeEscapeSequences(std::string_view line, std::string& result)
+        {
+            for (std::size_t index = 0; index < line.size(); ++index)
+            {
+                if (line[index] != '\\')
+                {
+                    result += line[index];
 
-                            isArrayKey = true;
-                            hasArrayIndex = true;
-                        }
+                    continue;
+                }
 
-                        while (line[characterIndex] != endCharacter)
-                        {
-                            if (line[characterIndex] == ' ')
-                            {
-                                ++characterIndex;
+                // A backslash at the end of the line can't start a valid escape sequence
+                if (++index >= line.size() || line[index] != 'x')
+                {
+                    throw std::runtime_error("Invalid escape character!");
+                }
 
-                                if (line[characterIndex] == endCharacter)
-                                {
-                                    newKey = false;
-                                }
+                std::locale loc;
 
-                                continue;
-                            }
+                std::string hexString;
 
-                            if (isArrayKey == false)
-                            {
-                                if (line[characterIndex] == '[')
-                                {
-                                    errorMessage += "Start section tag within key tag!\n";
-                                    break;
-                                }
-
-                                if (line[characterIndex] == ']')
-                                {
-                                    errorMessage += "Close section tag within key tag!\n";
-                                    break;
-                                }
-                            }
-                            else
-                            {
-                                // Key name complete once "[" character has been found
-                                if (line[characterIndex] == '[')
-                                {
-                                    newKey = false;
-                                    break;
-                                }
-                            }
+                bool isUnicodeEscapeSequence = false;
 
-                            if (line[characterIndex] == ';' || line[characterIndex] == '#')
-                            {
-                                errorMessage += "Found comment tag within key tag!\n";
-                                break;
-                            }
+                for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
+                {
+                    if (++index >= line.size() || std::isxdigit(line[index], loc) == false)
+                    {
+                        isUnicodeEscapeSequence = false;
 
-                            keyName += line[characterIndex];
+                        break;
+                    }
 
-                            ++characterIndex;
+                    isUnicodeEscapeSequence = true;
 
-                            if (line[characterIndex] == endCharacter)
-                            {
-                                newKey = false;
-                            }
-                        }
+                    hexString += line[index];
+                }
 
-                        if (newKey == true)
-                        {
-                            errorMessage += "Key end tag (\"";
-                            errorMessage += endCharacter;
-                            errorMessage += "\" sign) was not found!\n";
-                        }
+                if (isUnicodeEscapeSequence == false)
+                {
+                    // Set the index back by one character, otherwise the next character isn't processed!
+                    --index;
 
-                        if (errorMessage.empty() == true)
-                        {
-#ifndef HAVINI_CASE_SENSITIVE
-                            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                    // Don't eat the x character
+                    result += 'x';
+                    result += hexString;
 
-                            newKey = false;
-                            newValue = true;
-                        }
-                    }
+                    continue;
                 }
 
-                if (newValue == true)
+                unsigned int codePoint = std::strtol(hexString.c_str(), nullptr, 16);
+
+                if (index + 2 < line.size() && line[index + 1] == '\\' && line[index + 2] == 'x')
                 {
-                    value.clear();
+                    index += 2;
 
-                    std::size_t foundCharacter = line.find("=");
-                    std::size_t foundCharacter2 = line.find(":");
+                    bool surrogatePair = false;
 
-                    if (foundCharacter == std::string::npos && foundCharacter2 == std::string::npos)
-                    {
-                        errorMessage += "No \"=\" or \":\" sign found!\n";
-                    }
+                    hexString.clear();
 
-                    if (foundCharacter != std::string::npos && foundCharacter2 != std::string::npos)
-                    {
-                        if (foundCharacter > foundCharacter2)
-                        {
-                            characterIndex = foundCharacter2 + 1;
-                        }
-                        else
-                        {
-                            characterIndex = foundCharacter + 1;
-                        }
-                    }
-                    else
+                    for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
                     {
-                        if (foundCharacter != std::string::npos)
+                        if (++index >= line.size() || std::isxdigit(line[index], loc) == false)
                         {
-                            characterIndex = foundCharacter + 1;
-                        }
+                            surrogatePair = false;
 
-                        if (foundCharacter2 != std::string::npos)
-                        {
-                            characterIndex = foundCharacter2 + 1;
+                            break;
                         }
-                    }
 
-                    std::size_t quoteCharacterPos = 0;
-                    std::size_t allQuoteCharacters = 0;
+                        surrogatePair = true;
 
-                    while ((quoteCharacterPos = line.find("\"", quoteCharacterPos + 1)) != std::string::npos &&
-                           (quoteCharacterPos = line.find("\'", quoteCharacterPos + 1)) != std::string::npos)
-                    {
-                        ++allQuoteCharacters;
+                        hexString += line[index];
                     }
 
-                    if (errorMessage.empty() == true)
+                    if (surrogatePair == false)
                     {
-                        std::size_t currentQuoteCharacter = 0;
+                        throw std::runtime_error("Invalid code point for UTF-16 low surrogate pair!");
+                    }
 
-                        bool addQuotes = false;
+                    if (codePoint >= 0xd800 && codePoint <= 0xdbff)
+                    {
+                        unsigned int secondCodePoint = std::strtol(hexString.c_str(), nullptr, 16);
 
-                        while (line[characterIndex] != '\n')
+                        if (secondCodePoint < 0xdc00 || secondCodePoint > 0xdfff)
                         {
-                            if (line[characterIndex] == ' ' && stringValue == false)
-                            {
-                                ++characterIndex;
+                            throw std::runtime_error("Invalid code point range for UTF-16 low surrogate pair!");
+                        }
 
-                                if (line[characterIndex] == '\n')
-                                {
-                                    newValue = false;
-                                }
+                        // codePoint = high surrogate, secondCodePoint = low surrogate
+                        unsigned int surrogatePairValue = 0x10000 + ((codePoint - 0xd800) * 0x400) + (secondCodePoint - 0xdc00);
 
-                                continue;
-                            }
+                        result += CodePointToString(surrogatePairValue);
 
-                            if (line[characterIndex] == '[')
-                            {
-                                errorMessage += "Start section tag within value tag!\n";
-                                break;
-                            }
+                        continue;
+                    }
 
-                            if (line[characterIndex] == ']')
-                            {
-                                errorMessage += "Close section tag within value tag!\n";
-                                break;
-                            }
+                    // Set the index back by six characters, otherwise the possible next UTF-8 sequence isn't processed!
+                    index -= 6;
+                }
 
-                            if (allQuoteCharacters > 2)
-                            {
-                                if ((line[characterIndex] == '\"' || line[characterIndex] == '\'') && stringValue == false && currentQuoteCharacter == 0)
-                                {
-                                    stringValue = true;
+                result += CodePointToString(codePoint);
+            }
+        }
 
-                                    ++characterIndex;
+        std::size_t SkipWhitespaces(std::string_view line, std::size_t index, const std::ctype<char>& ctype)
+        {
+            while (index < line.size() && ctype.is(std::ctype_base::space, line[index]) == true)
+            {
+                ++index;
+            }
 
-                                    ++currentQuoteCharacter;
+            return index;
+        }
 
-                                    continue;
-                                }
+        std::string_view GetCommentText(std::string_view line, std::size_t commentCharacterIndex)
+        {
+            std::string_view comment = line.substr(commentCharacterIndex + 1);
 
-                                if ((line[characterIndex] == '\"' || line[characterIndex] == '\'') && stringValue == true && currentQuoteCharacter < allQuoteCharacters)
-                                {
-                                    ++currentQuoteCharacter;
-                                }
+            // Remove potential space character
+            if (comment.empty() == false && comment.front() == ' ')
+            {
+                comment.remove_prefix(1);
+            }
 
-                                if ((line[characterIndex] == '\"' || line[characterIndex] == '\'') && stringValue == true && currentQuoteCharacter == allQuoteCharacters)
-                                {
-                                    stringValue = false;
+            return comment;
+        }
 
-                                    ++currentQuoteCharacter;
+        havINISection& GetOrAddSection(std::string_view sectionName)
+        {
+            auto sectionEntry = FindSection(sectionName);
 
-                                    ++characterIndex;
+            if (sectionEntry != mData.end())
+            {
+                return *sectionEntry;
+            }
 
-                                    addQuotes = true;
+            mData.emplace_back(sectionName);
+            mSectionIndex.Insert(mData.back().GetSectionName(), mData.size() - 1);
 
-                                    continue;
-                                }
-                            }
-                            else
-                            {
-                                if ((line[characterIndex] == '\"' || line[characterIndex] == '\'') && stringValue == false)
-                                {
-                                    stringValue = true;
+            return mData.back();
+        }
 
-                                    ++characterIndex;
+        // Builds the document from the events of the tokenizer
+        struct havINIDocumentHandler
+        {
+            basic_havINIStream& stream;
+            bool collectParseStats = true;
 
-                                    continue;
-                                }
+            // Counts the line and the element, the build timer gets null if no stats are collected
+            havINIParseStats* CountLine(std::size_t havINIParseStats::* elementCount)
+            {
+                if (collectParseStats == false || stream.mCollectParseStats == false)
+                {
+                    return nullptr;
+                }
 
-                                if ((line[characterIndex] == '\"' || line[characterIndex] == '\'') && stringValue == true)
-                                {
-                                    stringValue = false;
+                ++stream.mParseStats.lineCount;
 
-                                    ++characterIndex;
+                if (elementCount != nullptr)
+                {
+                    ++(stream.mParseStats.*elementCount);
+                }
 
-                                    addQuotes = true;
+                return &stream.mParseStats;
+            }
 
-                                    continue;
-                                }
-                            }
+            bool OnSection(std::string_view sectionName, std::optional<std::string_view> inlineComment)
+            {
+                havINIStatsTimer buildTimer(CountLine(&havINIParseStats::sectionCount), &havINIParseStats::buildTime, &havINIParseStats::tokenizeTime);
 
-                            if (stringValue == false)
-                            {
-                                if (line[characterIndex] == ';' || line[characterIndex] == '#')
-                                {
-                                    // Inline comment
-                                    hasInlineComment = true;
+                havINISection& section = stream.GetOrAddSection(sectionName);
 
-                                    ++characterIndex;
+                if (inlineComment.has_value() == true && stream.mKeepInlineComments == true)
+                {
+                    section.SetInlineComment(inlineComment.value());
+                }
 
-                                    while (line[characterIndex] != '\n')
-                                    {
-                                        inlineComment += line[characterIndex];
-                                        ++characterIndex;
-                                    }
+                return true;
+            }
 
-                                    // Remove potential space character
-                                    if (inlineComment.front() == ' ')
-                                    {
-                                        inlineComment.erase(inlineComment.begin());
-                                    }
+            bool OnKey(std::string_view sectionName, std::string_view keyName, std::string_view value, bool isQuoted, std::optional<std::string_view> inlineComment)
+            {
+                havINIStatsTimer buildTimer(CountLine(&havINIParseStats::keyCount), &havINIParseStats::buildTime, &havINIParseStats::tokenizeTime);
 
-                                    newValue = false;
+                havINISection& section = stream.GetOrAddSection(sectionName);
 
-                                    break;
-                                }
-                            }
+                section.SetKeyValuePair(keyName, value, isQuoted);
 
-                            value += line[characterIndex];
+                if (stream.mKeepInlineComments == true)
+                {
+                    section.GetKeyValuePair(keyName)->SetInlineComment(inlineComment.value_or(std::string_view()));
+                }
 
-                            ++characterIndex;
+                return true;
+            }
 
-                            if (line[characterIndex] == '\n' && stringValue == true)
-                            {
-                                errorMessage += "String end tag not defined!\n";
+            bool OnArrayEntry(std::string_view sectionName, std::string_view keyName, std::optional<std::string_view> arrayIndex, std::string_view value, bool isQuoted, std::optional<std::string_view> inlineComment)
+            {
+                havINIStatsTimer buildTimer(CountLine(&havINIParseStats::keyCount), &havINIParseStats::buildTime, &havINIParseStats::tokenizeTime);
 
-                                break;
-                            }
+                if (stream.mKeepInlineComments == false)
+                {
+                    inlineComment = std::nullopt;
+                }
 
-                            if (line[characterIndex] == '\n')
-                            {
-                                newValue = false;
-                            }
-                        }
+                stream.GetOrAddSection(sectionName).SetArrayEntry(keyName, value, isQuoted, inlineComment.has_value(), inlineComment.value_or(std::string_view()),
+                    std::string(arrayIndex.value_or(std::string_view())), arrayIndex.has_value());
 
-                        if (newValue == true && stringValue == true)
-                        {
-                            errorMessage += "Value end tag (New line) was not found!\n";
-                        }
+                return true;
+            }
 
-                        if (errorMessage.empty() == true)
-                        {
-                            newValue = false;
+            bool OnComment(std::string_view sectionName, std::string_view comment)
+            {
+                havINIStatsTimer buildTimer(CountLine((stream.mKeepComments == true) ? &havINIParseStats::triviaCount : nullptr), &havINIParseStats::buildTime, &havINIParseStats::tokenizeTime);
 
-                            std::string newInlineComment = "";
+                if (stream.mKeepComments == true)
+                {
+                    std::string commentKeyStart = "HI_C_";
+                    CasePolicy::Fold(commentKeyStart);
 
-                            if (hasInlineComment == true)
-                            {
-                                newInlineComment = inlineComment;
-                            }
+                    havINISection& section = stream.GetOrAddSection(sectionName);
+                    section.SetComment(commentKeyStart + std::to_string(section.GetCommentLineCount()), comment, havINIPosition::End);
+                }
 
-                            if (HasSection(sectionName) == false)
-                            {
-#ifdef HAVINI_CASE_SENSITIVE
-                                havINISection newSectionForKeyValuePair(sectionName);
-#else
-                                havINISection newSectionForKeyValuePair(mLocale, sectionName);
-#endif
+                return true;
+            }
 
-                                if (isArrayKey == true)
-                                {
-                                    newSectionForKeyValuePair.SetArrayEntry(keyName, value, addQuotes, hasInlineComment, newInlineComment, arrayIndex, hasArrayIndex);
-                                }
-                                else
-                                {
-                                    newSectionForKeyValuePair.SetKeyValuePair(keyName, value, addQuotes);
-                                    auto keyValuePair = newSectionForKeyValuePair.GetKeyValuePair(keyName);
-                                    keyValuePair->SetInlineComment(newInlineComment);
-                                }
-
-                                mData.push_back(newSectionForKeyValuePair);
-                            }
-                            else
-                            {
-                                if (isArrayKey == true)
-                                {
-                                    GetSection(sectionName)->SetArrayEntry(keyName, value, addQuotes, hasInlineComment, newInlineComment, arrayIndex, hasArrayIndex);
-                                }
-                                else
-                                {
-                                    GetSection(sectionName)->SetKeyValuePair(keyName, value, addQuotes);
-                                    auto keyValuePair = GetSection(sectionName)->GetKeyValuePair(keyName);
-                                    keyValuePair->SetInlineComment(newInlineComment);
-                                }
-                            }
+            bool OnEmptyLine(std::string_view sectionName)
+            {
+                havINIStatsTimer buildTimer(CountLine((stream.mKeepEmptyLines == true) ? &havINIParseStats::triviaCount : nullptr), &havINIParseStats::buildTime, &havINIParseStats::tokenizeTime);
 
-                            hasInlineComment = false;
-                            inlineComment.clear();
+                if (stream.mKeepEmptyLines == true)
+                {
+                    std::string emptyLineKeyStart = "HI_EL_";
+                    CasePolicy::Fold(emptyLineKeyStart);
 
-                            newKey = true;
-                        }
-                    }
+                    havINISection& section = stream.GetOrAddSection(sectionName);
+                    section.SetEmptyLine(emptyLineKeyStart + std::to_string(section.GetEmptyLineCount()), havINIPosition::End);
                 }
-            }
 
-            if (errorMessage.empty() == false)
-            {
-                std::cout << "Error while reading INI file: " << errorMessage << std::endl;
-
-                errorMessage.clear();
+                return true;
             }
+        };
 
-            // A section is missing when a section is at the end of the INI file and doesn't have any key value pairs
-            if (HasSection(sectionName) == false)
-            {
-#ifdef HAVINI_CASE_SENSITIVE
-                mData.emplace_back(sectionName);
-#else
-                mData.emplace_back(mLocale, sectionName);
-#endif
-            }
+        bool ParseLine(std::string_view line, const std::ctype<char>& ctype, bool nonASCIISpaces, std::string& sectionName, std::string& nameBuffer, std::string& valueBuffer, std::string& errorMessage)
+        {
+            havINIDocumentHandler handler{ *this };
 
-            return true;
+            return TokenizeLine(line, ctype, nonASCIISpaces, sectionName, nameBuffer, valueBuffer, errorMessage, handler);
         }
 
-        bool WriteFile(const std::string& fileName, bool formatted = false, havINIBOMType bomType = havINIBOMType::None)
+        // Whitespaces are ignored, except in (inline) comments and quoted values. The handler is called with the section name, key names and values as they
+        // are stored in the document. False is returned on an error (errorMessage isn't empty) or if the handler stopped the parsing (errorMessage is empty).
+        template<class Handler>
+        bool TokenizeLine(std::string_view line, const std::ctype<char>& ctype, bool nonASCIISpaces, std::string& sectionName, std::string& nameBuffer, std::string& valueBuffer,
+            std::string& errorMessage, Handler& handler)
         {
-            // Open file stream
-#ifdef _WIN32
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
-#else
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
-#endif
+            std::size_t index = SkipWhitespaces(line, 0, ctype);
 
-            if (fileStream == nullptr)
+            // Empty line
+            if (index == line.size())
             {
-                std::cout << "Unable to write INI file: " << fileName << "\n";
+                return handler.OnEmptyLine(sectionName);
+            }
 
-                return false;
+            // Comment
+            if (line[index] == ';' || line[index] == '#')
+            {
+                return handler.OnComment(sectionName, GetCommentText(line, index));
             }
 
-            if (bomType != havINIBOMType::None)
+            // Section
+            if (line[index] == '[')
             {
-                if (bomType == havINIBOMType::UTF8)
+                havINIToken newSectionName(nameBuffer);
+
+                bool sectionEndFound = false;
+
+                for (++index; index < line.size(); ++index)
                 {
-                    // Write UTF-8 BOM at the beginning of the INI file
-                    const unsigned char bomArray[3] = { 0xef, 0xbb, 0xbf };
+                    char currentChar = line[index];
 
-                    for (unsigned int index = 0; index < 3; ++index)
+                    if (ctype.is(std::ctype_base::space, currentChar) == true)
                     {
-                        std::fwrite(&bomArray[index], sizeof(unsigned char), 1, fileStream.get());
+                        continue;
                     }
-                }
-                else if (bomType == havINIBOMType::UTF16LE)
-                {
-                    // Write UTF-16 Little Endian BOM at the beginning of the INI file
-                    const unsigned char bomArray[2] = { 0xff, 0xfe };
 
-                    for (unsigned int index = 0; index < 2; ++index)
+                    if (currentChar == '[')
                     {
-                        std::fwrite(&bomArray[index], sizeof(unsigned char), 1, fileStream.get());
+                        errorMessage += "New section started within section tag!\n";
+                        break;
                     }
-                }
-                else if (bomType == havINIBOMType::UTF16BE)
-                {
-                    // Write UTF-16 Big Endian BOM at the beginning of the INI file
-                    const unsigned char bomArray[2] = { 0xfe, 0xff };
 
-                    for (unsigned int index = 0; index < 2; ++index)
+                    if (currentChar == ']')
                     {
-                        std::fwrite(&bomArray[index], sizeof(unsigned char), 1, fileStream.get());
+                        sectionEndFound = true;
+
+                        continue;
                     }
-                }
-                else if (bomType == havINIBOMType::UTF32LE)
-                {
-                    // Write UTF-32 Little Endian BOM at the beginning of the INI file
-                    const unsigned char bomArray[4] = { 0xff, 0xfe, 0x00, 0x00 };
 
-                    for (unsigned int index = 0; index < 4; ++index)
+                    if (currentChar == ';' || currentChar == '#')
                     {
-                        std::fwrite(&bomArray[index], sizeof(unsigned char), 1, fileStream.get());
+                        if (sectionEndFound == false)
+                        {
+                            errorMessage += "Found comment tag within section tag!\n";
+                            break;
+                        }
+
+                        // Section inline comment
+                        sectionName = std::string(newSectionName.View(line));
+
+                        CasePolicy::Fold(sectionName);
+
+                        return handler.OnSection(sectionName, GetCommentText(line, index));
                     }
+
+                    newSectionName.Append(line, index);
                 }
-                else if (bomType == havINIBOMType::UTF32BE)
+
+                if (sectionEndFound == false)
                 {
-                    // Write UTF-32 Big Endian BOM at the beginning of the INI file
-                    const unsigned char bomArray[4] = { 0x00, 0x00, 0xfe, 0xff };
+                    errorMessage += "Section end tag was not found!\n";
+                }
 
-                    for (unsigned int index = 0; index < 4; ++index)
-                    {
-                        std::fwrite(&bomArray[index], sizeof(unsigned char), 1, fileStream.get());
-                    }
+                if (errorMessage.empty() == false)
+                {
+                    return false;
                 }
+
+                sectionName = std::string(newSectionName.View(line));
+
+                CasePolicy::Fold(sectionName);
+
+                return handler.OnSection(sectionName, std::nullopt);
             }
 
-            // Write INI file contents
-            for (auto sectionIterator = mData.begin(); sectionIterator != mData.end(); ++sectionIterator)
+            // Key value pair, the first "=" or ":" sign separates the key from the value
+            std::size_t delimiterIndex = line.find_first_of("=:", index);
+
+            if (delimiterIndex == std::string_view::npos)
             {
-                std::string sectionName = "";
+                errorMessage += "No \"=\" or \":\" sign found!\n";
 
-                const std::vector<havINIData>& sectionKeyValuePairs = (*sectionIterator).GetKeyValuePairs();
+                return false;
+            }
 
-                if ((*sectionIterator).GetSectionName() != "HI_Global" &&
-                    (*sectionIterator).GetSectionName() != "hi_global")
-                {
-                    std::string newline = ((sectionIterator == mData.begin()) ? "" : GetNewline());
+            havINIToken fullKey(nameBuffer);
 
-                    // Prevent adding a new line, if the file or the global section is empty, however, we need to take possible BOM into consideration
-                    if (bomType == havINIBOMType::None)
-                    {
-                        if (std::ftell(fileStream.get()) > 0)
-                        {
-                            sectionName += newline;
-                        }
-                    }
-                    else if (bomType == havINIBOMType::UTF8)
-                    {
-                        if (std::ftell(fileStream.get()) > 3)
-                        {
-                            sectionName += newline;
-                        }
-                    }
-                    else if (bomType == havINIBOMType::UTF16LE || bomType == havINIBOMType::UTF16BE)
-                    {
-                        if (std::ftell(fileStream.get()) > 2)
-                        {
-                            sectionName += newline;
-                        }
-                    }
-                    else if (bomType == havINIBOMType::UTF32LE || bomType == havINIBOMType::UTF32BE)
-                    {
-                        if (std::ftell(fileStream.get()) > 4)
-                        {
-                            sectionName += newline;
-                        }
-                    }
+            std::string_view keyLine = line.substr(0, delimiterIndex);
 
-                    sectionName += "[";
-                    sectionName += ConvertToEscapedString((*sectionIterator).GetSectionName());
-                    sectionName += "]";
+            while (index < delimiterIndex)
+            {
+                // Only characters which may be whitespaces are checked with the locale
+                std::size_t runEnd = havUtils::FindNextStructuralCharacter(keyLine, index, {}, true, nonASCIISpaces);
 
-                    if ((*sectionIterator).HasInlineComment() == true)
-                    {
-                        if (formatted == true)
-                        {
-                            sectionName += " ";
-                        }
-                        sectionName += GetCommentCharacter();
-                        sectionName += " ";
-                        sectionName += ConvertToEscapedString((*sectionIterator).GetInlineComment());
-                    }
+                fullKey.Append(line, index, runEnd - index);
+                index = runEnd;
 
-                    if (formatted == true && sectionKeyValuePairs.empty() == true)
-                    {
-                        sectionName += GetNewline();
-                    }
+                if (index == delimiterIndex)
+                {
+                    break;
+                }
 
-                    WriteStringToFile(sectionName, fileStream.get(), bomType);
+                if (ctype.is(std::ctype_base::space, line[index]) == false)
+                {
+                    fullKey.Append(line, index);
                 }
 
-                for (auto keyValuePairIterator = sectionKeyValuePairs.begin(); keyValuePairIterator != sectionKeyValuePairs.end(); ++keyValuePairIterator)
+                ++index;
+            }
+
+            std::string_view keyView = fullKey.View(line);
+            std::string_view arrayIndex;
+
+            bool isArrayKey = false;
+            bool hasArrayIndex = false;
+
+            if (havUtils::EndsWith(keyView, "[]") == true)
+            {
+                isArrayKey = true;
+            }
+            else if (havUtils::StartsWith(keyView, "[") == false && havUtils::EndsWith(keyView, "]") == true && keyView.find('[') != std::string_view::npos)
+            {
+                arrayIndex = keyView.substr(keyView.find('[') + 1);
+                arrayIndex = arrayIndex.substr(0, arrayIndex.find('['));
+
+                // Remove "]" character
+                if (arrayIndex.empty() == false && arrayIndex.back() == ']')
                 {
-                    std::string newline = (sectionName.empty() == true && keyValuePairIterator == sectionKeyValuePairs.begin()) ? "" : GetNewline();
+                    arrayIndex.remove_suffix(1);
+                }
 
-                    std::string keyValuePair;
+                isArrayKey = true;
+                hasArrayIndex = true;
+            }
 
-                    if ((*keyValuePairIterator).GetType() == havINIDataType::Empty)
+            for (std::size_t keyIndex = 0; keyIndex < keyView.size(); ++keyIndex)
+            {
+                if (isArrayKey == false)
+                {
+                    if (keyView[keyIndex] == '[')
                     {
-                        keyValuePair = newline;
+                        errorMessage += "Start section tag within key tag!\n";
+                        break;
                     }
-                    else if ((*keyValuePairIterator).GetType() == havINIDataType::Comment)
+
+                    if (keyView[keyIndex] == ']')
                     {
-                        keyValuePair = newline;
-                        keyValuePair += GetCommentCharacter();
-                        keyValuePair += " ";
-                        keyValuePair += ConvertToEscapedString((*keyValuePairIterator).GetValue());
+                        errorMessage += "Close section tag within key tag!\n";
+                        break;
                     }
-                    else if ((*keyValuePairIterator).GetType() == havINIDataType::Array)
-                    {
-                        for (auto arrayIterator = (*keyValuePairIterator).ArrayCBegin(); arrayIterator != (*keyValuePairIterator).ArrayCEnd(); ++arrayIterator)
-                        {
-                            std::string value = ConvertToEscapedString((*arrayIterator).GetValue());
+                }
+                else if (keyView[keyIndex] == '[')
+                {
+                    // Key name complete once "[" character has been found
+                    keyView = keyView.substr(0, keyIndex);
+                    break;
+                }
 
-                            if ((*arrayIterator).GetAddQuotes() == true)
-                            {
-                                value = GetValueQuoteCharacter() + value + GetValueQuoteCharacter();
-                            }
+                if (keyView[keyIndex] == ';' || keyView[keyIndex] == '#')
+                {
+                    errorMessage += "Found comment tag within key tag!\n";
+                    break;
+                }
+            }
 
-                            if ((*keyValuePairIterator).HasArrayIndex() == true)
-                            {
-                                keyValuePair = newline;
-                                keyValuePair += ConvertToEscapedString((*keyValuePairIterator).GetKey());
-                                keyValuePair += "[";
-                                keyValuePair += ConvertToEscapedString((*arrayIterator).GetKey());
-                                keyValuePair += "]";
-                                if (formatted == true)
-                                {
-                                    keyValuePair += " ";
-                                }
-                                keyValuePair += GetKeyValuePairDelimiter();
-                                if (formatted == true)
-                                {
-                                    keyValuePair += " ";
-                                }
-                                keyValuePair += value;
-                            }
-                            else
-                            {
-                                keyValuePair = newline;
-                                keyValuePair += ConvertToEscapedString((*keyValuePairIterator).GetKey());
-                                keyValuePair += "[]";
-                                if (formatted == true)
-                                {
-                                    keyValuePair += " ";
-                                }
-                                keyValuePair += GetKeyValuePairDelimiter();
-                                if (formatted == true)
-                                {
-                                    keyValuePair += " ";
-                                }
-                                keyValuePair += value;
-                            }
+            // An incomplete key is always reported as well
+            if (errorMessage.empty() == false || (isArrayKey == false && keyView.empty() == true))
+            {
+                errorMessage += "Key end tag (\"";
+                errorMessage += line[delimiterIndex];
+                errorMessage += "\" sign) was not found!\n";
+            }
 
-                            if ((*arrayIterator).HasInlineComment() == true)
-                            {
-                                if (formatted == true)
-                                {
-                                    keyValuePair += " ";
-                                }
-                                keyValuePair += GetCommentCharacter();
-                                keyValuePair += " ";
-                                keyValuePair += ConvertToEscapedString((*arrayIterator).GetInlineComment());
-                            }
+            if (errorMessage.empty() == false)
+            {
+                return false;
+            }
 
-                            if (formatted == true &&
-                                arrayIterator + 1 == (*keyValuePairIterator).ArrayCEnd() &&
-                                keyValuePairIterator + 1 == sectionKeyValuePairs.end())
-                            {
-                                keyValuePair += GetNewline();
-                            }
+            std::string keyName(keyView);
+
+            CasePolicy::Fold(keyName);
+
+            // Value
+            havINIToken value(valueBuffer);
+
+            std::optional<std::string_view> inlineComment;
+
+            bool stringValue = false;
+            bool addQuotes = false;
+            std::size_t stringValueStart = 0;
+
+            for (index = delimiterIndex + 1; index < line.size(); ++index)
+            {
+                // Jump straight to the next character which needs to be looked at, everything in between belongs to the value
+                std::size_t runEnd = (stringValue == true) ? havUtils::FindNextStructuralCharacter(line, index, "[]\"'", false, false) : havUtils::FindNextStructuralCharacter(line, index, "[]\"';#", true, nonASCIISpaces);
+
+                value.Append(line, index, runEnd - index);
+                index = runEnd;
+
+                if (index == line.size())
+                {
+                    break;
+                }
+
+                char currentChar = line[index];
+
+                if (stringValue == false && ctype.is(std::ctype_base::space, currentChar) == true)
+                {
+                    continue;
+                }
 
-                            WriteStringToFile(keyValuePair, fileStream.get(), bomType);
-                        }
+                if (currentChar == '[')
+                {
+                    errorMessage += "Start section tag within value tag!\n";
+                    return false;
+                }
 
-                        // All array entries have been written, so continue with the next key value pair
-                        continue;
+                if (currentChar == ']')
+                {
+                    errorMessage += "Close section tag within value tag!\n";
+                    return false;
+                }
+
+                if (currentChar == '\"' || currentChar == '\'')
+                {
+                    if (stringValue == true)
+                    {
+                        addQuotes = true;
                     }
                     else
                     {
-                        std::string value = ConvertToEscapedString((*keyValuePairIterator).GetValue());
+                        stringValueStart = index + 1;
+                    }
 
-                        if ((*keyValuePairIterator).GetAddQuotes() == true)
-                        {
-                            value = GetValueQuoteCharacter() + value + GetValueQuoteCharacter();
-                        }
+                    stringValue = !stringValue;
 
-                        keyValuePair = newline;
-                        keyValuePair += ConvertToEscapedString((*keyValuePairIterator).GetKey());
-                        if (formatted == true)
-                        {
-                            keyValuePair += " ";
-                        }
-                        keyValuePair += GetKeyValuePairDelimiter();
-                        if (formatted == true)
-                        {
-                            keyValuePair += " ";
-                        }
-                        keyValuePair += value;
-                    }
+                    continue;
+                }
 
-                    if ((*keyValuePairIterator).HasInlineComment() == true)
-                    {
-                        if (formatted == true)
-                        {
-                            keyValuePair += " ";
-                        }
-                        keyValuePair += GetCommentCharacter();
-                        keyValuePair += " ";
-                        keyValuePair += ConvertToEscapedString((*keyValuePairIterator).GetInlineComment());
-                    }
+                if (stringValue == false && (currentChar == ';' || currentChar == '#'))
+                {
+                    inlineComment = GetCommentText(line, index);
+                    break;
+                }
 
-                    if (formatted == true &&
-                        keyValuePairIterator + 1 == sectionKeyValuePairs.end() &&
-                        (*keyValuePairIterator).GetType() != havINIDataType::Empty)
-                    {
-                        keyValuePair += GetNewline();
-                    }
+                value.Append(line, index);
+            }
 
-                    WriteStringToFile(keyValuePair, fileStream.get(), bomType);
+            if (stringValue == true)
+            {
+                if (stringValueStart < line.size())
+                {
+                    errorMessage += "String end tag not defined!\n";
                 }
+
+                errorMessage += "Value end tag (New line) was not found!\n";
+
+                return false;
             }
 
-            return true;
-        }
+            std::string_view newValue = value.View(line);
 
-        bool SetEmptyLine(std::string sectionName, const havINIPosition& position, std::optional<std::string> keyName = std::nullopt)
-        {
-            if (sectionName.empty() == true)
+            if (isArrayKey == true)
             {
-                sectionName = "HI_Global";
+                return handler.OnArrayEntry(sectionName, keyName, (hasArrayIndex == true) ? std::optional<std::string_view>(arrayIndex) : std::nullopt, newValue, addQuotes, inlineComment);
             }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            return handler.OnKey(sectionName, keyName, newValue, addQuotes, inlineComment);
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        typename havINISectionVector::iterator GetSection(std::string_view sectionName)
+        {
+            return FindSection(sectionName);
+        }
 
-            if (sectionEntry != mData.end())
+        std::size_t FindSectionSlot(std::string_view sectionName)
+        {
+            std::size_t renameCount = havINISection::sRenameCount.load(std::memory_order_relaxed);
+
+            // A section may have been renamed through its public SetSectionName
+            if (renameCount != mSectionRenameCount)
             {
-                std::string emptyLineKeyStart = "HI_EL_";
+                mSectionIndex.Invalidate();
+                mSectionRenameCount = renameCount;
+            }
 
-#ifndef HAVINI_CASE_SENSITIVE
-                emptyLineKeyStart = havUtils::ToLower(emptyLineKeyStart, mLocale);
+            return mSectionIndex.Find(sectionName, mData, [](const havINISection& section) -> std::string_view { return section.GetSectionName(); } );
+        }
 
-                if (keyName.has_value() == true)
-                {
-                    keyName = havUtils::ToLower(keyName.value(), mLocale);
-                }
-#endif
+        // A section which has been found is parsed, if lazy parsing skipped it so far
+        typename havINISectionVector::iterator FindSection(std::string_view sectionName)
+        {
+            std::size_t slot = FindSectionSlot(sectionName);
 
-                sectionEntry->SetEmptyLine(emptyLineKeyStart + std::to_string(sectionEntry->GetEmptyLineCount()), position, keyName);
+            if (slot == havINIHashIndex<CasePolicy, Allocator>::npos)
+            {
+                return mData.end();
+            }
 
-                return true;
+            if (IsSectionPending(slot) == true)
+            {
+                ParsePendingSection(slot);
             }
 
-            return false;
+            return mData.begin() + slot;
         }
 
-        std::vector<std::string> GetEmptyLineKeyNames(std::string sectionName)
+        // Builds the UTF-8 INI contents, all lines are appended to a single buffer
+        std::string BuildContents(bool formatted)
         {
-            if (sectionName.empty() == true)
-            {
-                sectionName = "HI_Global";
-            }
+            ParsePendingSections();
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            std::string contents;
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            bool reuseWrittenContents = (mIncrementalWrite == true && GetWriteFormat(formatted) == mWrittenFormat);
 
-            if (sectionEntry != mData.end())
+            // Reserve a rough estimate of the output size (Escape sequences are not taken into account), so the buffer rarely needs to grow while building
+            std::size_t estimatedSize = 0;
+
+            for (havINISection& section : mData)
             {
-                std::string emptyLineKeyStart = "HI_EL_";
+                // The flags of the key value pairs are only collected once
+                section.mIsModified = section.IsModified();
 
-#ifndef HAVINI_CASE_SENSITIVE
-                emptyLineKeyStart = havUtils::ToLower(emptyLineKeyStart, mLocale);
-#endif
+                if (section.mIsModified == false && reuseWrittenContents == true)
+                {
+                    estimatedSize += section.mWrittenContents.size() + mNewline.size();
 
-                return sectionEntry->GetEmptyLineKeyNames(emptyLineKeyStart);
-            }
+                    continue;
+                }
 
-            return {};
-        }
+                estimatedSize += section.GetSectionName().size() + 8;
 
-        bool RemoveEmptyLine(std::string sectionName, std::string keyName)
-        {
-            if (sectionName.empty() == true)
-            {
-                sectionName = "HI_Global";
+                for (const havINIData& keyValuePair : section.GetKeyValuePairs())
+                {
+                    estimatedSize += keyValuePair.GetKey().size() + keyValuePair.GetValue().size() + 8;
+
+                    if (keyValuePair.GetType() != havINIDataType::Array)
+                    {
+                        continue;
+                    }
+
+                    for (auto arrayIterator = keyValuePair.ArrayCBegin(); arrayIterator != keyValuePair.ArrayCEnd(); ++arrayIterator)
+                    {
+                        estimatedSize += keyValuePair.GetKey().size() + (*arrayIterator).GetKey().size() + (*arrayIterator).GetValue().size() + 10;
+                    }
+                }
+
+                for (const havINIData& trivia : section.GetTrivia())
+                {
+                    estimatedSize += trivia.GetValue().size() + 4;
+                }
             }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            contents.reserve(estimatedSize);
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            const std::string& newlineCharacters = GetNewline();
 
-            if (sectionEntry != mData.end())
+            for (auto sectionIterator = mData.begin(); sectionIterator != mData.end(); ++sectionIterator)
             {
-#ifndef HAVINI_CASE_SENSITIVE
-                keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                havINISection& section = *sectionIterator;
 
-                return sectionEntry->RemoveEmptyLine(keyName);
-            }
+                // Prevent adding a new line, if the file or the global section is empty
+                if (section.GetSectionName() != "HI_Global" && section.GetSectionName() != "hi_global" &&
+                    sectionIterator != mData.begin() && contents.empty() == false)
+                {
+                    contents += newlineCharacters;
+                }
 
-            return false;
-        }
+                if (mIncrementalWrite == false)
+                {
+                    AppendSection(contents, section, formatted);
+                }
+                else if (section.mIsModified == false && reuseWrittenContents == true)
+                {
+                    // Unchanged sections are copied as they were written last time
+                    contents.append(section.mWrittenContents.data(), section.mWrittenContents.size());
+                }
+                else
+                {
+                    std::size_t sectionStart = contents.size();
 
-        bool AddSection(std::string sectionName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+                    AppendSection(contents, section, formatted);
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+                    section.mWrittenContents.assign(contents.data() + sectionStart, contents.size() - sectionStart);
+                    section.ClearModified();
+                }
+            }
 
-            if (sectionEntry == mData.end())
+            if (mIncrementalWrite == true)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                mData.emplace_back(sectionName);
-#else
-                mData.emplace_back(mLocale, sectionName);
-#endif
-
-                return true;
+                mWrittenFormat = GetWriteFormat(formatted);
             }
 
-            return false;
+            return contents;
         }
 
-        std::string GetValue(std::string sectionName, std::string keyName, const std::string& defaultValue)
+        // Appends a section without the newline in front of it, the output only depends on the section and the format settings
+        void AppendSection(std::string& contents, const havINISection& section, bool formatted)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            const std::string& newlineCharacters = GetNewline();
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            bool hasSectionTag = false;
 
-            if (sectionEntry != mData.end())
+            std::size_t entryCount = section.GetKeyValuePairs().size() + section.GetTrivia().size();
+
+            if (section.GetSectionName() != "HI_Global" &&
+                section.GetSectionName() != "hi_global")
             {
-                const std::vector<havINIData>& keyValuePairs = sectionEntry->GetKeyValuePairs();
+                hasSectionTag = true;
 
-#ifndef HAVINI_CASE_SENSITIVE
-                keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+                contents += "[";
+                contents += ConvertToEscapedString(section.GetSectionName());
+                contents += "]";
 
-                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
+                if (section.HasInlineComment() == true)
+                {
+                    if (formatted == true)
+                    {
+                        contents += " ";
+                    }
+                    contents += GetCommentCharacter();
+                    contents += " ";
+                    contents += ConvertToEscapedString(section.GetInlineComment());
+                }
 
-                if (keyValuePair != keyValuePairs.end())
+                if (formatted == true && entryCount == 0)
                 {
-                    return keyValuePair->GetValue();
+                    contents += newlineCharacters;
                 }
             }
 
-            return defaultValue;
-        }
-
-        bool SetValue(std::string sectionName, std::string keyName, const std::string& value, bool addQuotes)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+            // Comments and empty lines are written in between the key value pairs they were read with
+            std::size_t entryIndex = 0;
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
-
-            if (sectionEntry != mData.end())
+            section.ForEachEntry([&](const havINIData& keyValuePair)
             {
-                const std::vector<havINIData>& keyValuePairs = sectionEntry->GetKeyValuePairs();
+                bool addNewline = (hasSectionTag == false && entryIndex == 0) ? false : true;
 
-                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
+                ++entryIndex;
 
-                if (keyValuePair != keyValuePairs.end())
+                if (keyValuePair.GetType() == havINIDataType::Empty)
                 {
-                    keyValuePair->SetValue(value);
-                    keyValuePair->SetAddQuotes(addQuotes);
+                    if (addNewline == true)
+                    {
+                        contents += newlineCharacters;
+                    }
+                }
+                else if (keyValuePair.GetType() == havINIDataType::Comment)
+                {
+                    if (addNewline == true)
+                    {
+                        contents += newlineCharacters;
+                    }
+                    contents += GetCommentCharacter();
+                    contents += " ";
+                    contents += ConvertToEscapedString(keyValuePair.GetValue());
+                }
+                else if (keyValuePair.GetType() == havINIDataType::Array)
+                {
+                    for (auto arrayIterator = keyValuePair.ArrayCBegin(); arrayIterator != keyValuePair.ArrayCEnd(); ++arrayIterator)
+                    {
+                        if (addNewline == true)
+                        {
+                            contents += newlineCharacters;
+                        }
+                        contents += ConvertToEscapedString(keyValuePair.GetKey());
 
-                    return true;
+                        if (keyValuePair.HasArrayIndex() == true)
+                        {
+                            contents += "[";
+                            contents += ConvertToEscapedString((*arrayIterator).GetKey());
+                            contents += "]";
+                        }
+                        else
+                        {
+                            contents += "[]";
+                        }
+
+                        if (formatted == true)
+                        {
+                            contents += " ";
+                        }
+                        contents += GetKeyValuePairDelimiter();
+                        if (formatted == true)
+                        {
+                            contents += " ";
+                        }
+
+                        AppendValue(contents, (*arrayIterator).GetValue(), (*arrayIterator).GetAddQuotes());
+
+                        if ((*arrayIterator).HasInlineComment() == true)
+                        {
+                            if (formatted == true)
+                            {
+                                contents += " ";
+                            }
+                            contents += GetCommentCharacter();
+                            contents += " ";
+                            contents += ConvertToEscapedString((*arrayIterator).GetInlineComment());
+                        }
+
+                        if (formatted == true &&
+                            arrayIterator + 1 == keyValuePair.ArrayCEnd() &&
+                            entryIndex == entryCount)
+                        {
+                            contents += newlineCharacters;
+                        }
+                    }
+
+                    // All array entries have been written, so continue with the next key value pair
+                    return;
                 }
                 else
                 {
-                    sectionEntry->SetKeyValuePair(keyName, value, addQuotes);
+                    if (addNewline == true)
+                    {
+                        contents += newlineCharacters;
+                    }
+                    contents += ConvertToEscapedString(keyValuePair.GetKey());
+                    if (formatted == true)
+                    {
+                        contents += " ";
+                    }
+                    contents += GetKeyValuePairDelimiter();
+                    if (formatted == true)
+                    {
+                        contents += " ";
+                    }
 
-                    return true;
+                    AppendValue(contents, keyValuePair.GetValue(), keyValuePair.GetAddQuotes());
                 }
-            }
-            else
-            {
-#ifdef HAVINI_CASE_SENSITIVE
-                havINISection newSection(sectionName);
-#else
-                havINISection newSection(mLocale, sectionName);
-#endif
-                newSection.SetKeyValuePair(keyName, value, addQuotes);
-                mData.push_back(newSection);
 
-                return true;
-            }
+                if (keyValuePair.HasInlineComment() == true)
+                {
+                    if (formatted == true)
+                    {
+                        contents += " ";
+                    }
+                    contents += GetCommentCharacter();
+                    contents += " ";
+                    contents += ConvertToEscapedString(keyValuePair.GetInlineComment());
+                }
 
-            return false;
+                if (formatted == true &&
+                    entryIndex == entryCount &&
+                    keyValuePair.GetType() != havINIDataType::Empty)
+                {
+                    contents += newlineCharacters;
+                }
+            });
         }
 
-        bool SetComment(std::string sectionName, const std::string& comment, const havINIPosition& position, std::optional<std::string> keyName = std::nullopt)
+        // Settings which change the contents written by AppendSection
+        std::string GetWriteFormat(bool formatted) const
         {
-            if (sectionName.empty() == true)
+            std::string writeFormat = mNewline;
+
+            writeFormat += (formatted == true) ? '1' : '0';
+            writeFormat += mCommentCharacter;
+            writeFormat += mValueQuoteCharacter;
+            writeFormat += mKeyValuePairDelimiter;
+
+            return writeFormat;
+        }
+
+        void AppendValue(std::string& contents, std::string_view value, bool addQuotes)
+        {
+            if (addQuotes == true)
             {
-                sectionName = "HI_Global";
+                contents += GetValueQuoteCharacter();
             }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
+            contents += ConvertToEscapedString(value);
 
-            if (keyName.has_value() == true)
+            if (addQuotes == true)
             {
-                keyName = havUtils::ToLower(keyName.value(), mLocale);
+                contents += GetValueQuoteCharacter();
             }
-#endif
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        // Converts the UTF-8 INI contents to the specified encoding in one pass and puts the BOM in front
+        std::string EncodeContents(std::string contents, havINIBOMType bomType)
+        {
+            std::string encodedContents;
 
-            if (sectionEntry != mData.end())
+            if (bomType == havINIBOMType::None)
             {
-#ifdef HAVINI_CASE_SENSITIVE
-                std::string commentKeyStart = "HI_C_";
-#else
-                std::string commentKeyStart = "hi_c_";
-#endif
-
-                sectionEntry->SetComment(commentKeyStart + std::to_string(sectionEntry->GetCommentLineCount()), comment, position, keyName);
+                return contents;
+            }
 
-                return true;
+            if (bomType == havINIBOMType::UTF8)
+            {
+                encodedContents.reserve(contents.size() + 3);
+                encodedContents += "\xef\xbb\xbf";
+                encodedContents += contents;
+            }
+            else if (bomType == havINIBOMType::UTF16LE || bomType == havINIBOMType::UTF16BE)
+            {
+                encodedContents = havUtils::UTF8ToUTF16(contents, bomType == havINIBOMType::UTF16BE, true);
+            }
+            else if (bomType == havINIBOMType::UTF32LE || bomType == havINIBOMType::UTF32BE)
+            {
+                encodedContents = havUtils::UTF8ToUTF32(contents, bomType == havINIBOMType::UTF32BE, true);
             }
 
-            return false;
+            return encodedContents;
         }
 
-        std::vector<std::string> GetCommentKeyNames(std::string sectionName)
+        // Default INI newline, characters and delimiter
+        std::string mNewline = "\r\n";
+        char mCommentCharacter = ';';
+        char mValueQuoteCharacter = '\"';
+        char mKeyValuePairDelimiter = '=';
+
+        std::locale mLocale = std::locale();
+        bool mKeepComments = true;
+        bool mKeepEmptyLines = true;
+        bool mKeepInlineComments = true;
+        bool mLazyParsing = false;
+        bool mIncrementalWrite = false;
+        bool mAtomicWrite = false;
+        unsigned int mParseThreadCount = 1;
+        havINIParseExecutor mParseExecutor;
+        havINIDiagnosticSink mDiagnosticSink;
+        bool mCollectParseStats = false;
+        havINIParseStats mParseStats;
+
+        // A section contains key value pairs. Its comments (HI_C_x) and empty lines (HI_EL_x) are kept in a side table of the section, see basic_havINISection::GetTrivia.
+        havINISectionVector mData;
+        havINIHashIndex<CasePolicy, Allocator> mSectionIndex; // Section name -> slot in mData
+        std::size_t mSectionRenameCount = 0; // havINISection::sRenameCount when mSectionIndex was last checked
+
+        havINISourceSectionVector mSourceSections;
+        bool mSourceSectionsValid = false;
+        std::string mSourceFileName;
+        havINIFileState mSourceFileState;
+
+        // Format of the contents in havINISection::mWrittenContents and the file written last time with incremental write
+        std::string mWrittenFormat;
+        std::string mWrittenFileName;
+        std::filesystem::file_time_type mWrittenWriteTime = std::filesystem::file_time_type::min();
+        std::uint64_t mWrittenHash = 0;
+        std::size_t mWrittenSize = 0;
+
+        std::string mPendingContents; // Copy of the contents, as long as lazy parsing skipped any section
+        havINIPendingRangeVector mPendingRanges;
+        havINIPendingSlotVector mPendingSections; // Slot in mData -> first range in mPendingRanges + 1, zero if the section has been parsed
+        std::size_t mPendingSectionCount = 0;
+    };
+
+    // Holds the current snapshot of a configuration which is read by many threads and replaced by a reloader thread.
+    // Readers get a reference counted handle and never wait for a reload, because the new document is parsed and frozen
+    // before it gets published. An old snapshot is freed when the last handle to it is released.
+    template<class CasePolicy>
+    class basic_havINISharedConfig
+    {
+    public:
+        using havINISnapshot = basic_havINISnapshot<CasePolicy>;
+        using havINISnapshotHandle = std::shared_ptr<const havINISnapshot>;
+
+        basic_havINISharedConfig() : mSnapshot(std::make_shared<const havINISnapshot>())
         {
-            if (sectionName.empty() == true)
-            {
-                sectionName = "HI_Global";
-            }
+        }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+        explicit basic_havINISharedConfig(havINISnapshot snapshot) : mSnapshot(std::make_shared<const havINISnapshot>(std::move(snapshot)))
+        {
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        basic_havINISharedConfig(const basic_havINISharedConfig& value) = delete;
+        basic_havINISharedConfig& operator=(const basic_havINISharedConfig& value) = delete;
 
-            if (sectionEntry != mData.end())
-            {
-#ifdef HAVINI_CASE_SENSITIVE
-                std::string commentKeyStart = "HI_C_";
+        // Keep the handle for a whole request, so all lookups see the same version of the document
+        havINISnapshotHandle GetSnapshot() const
+        {
+#ifdef __cpp_lib_atomic_shared_ptr
+            return mSnapshot.load(std::memory_order_acquire);
 #else
-                std::string commentKeyStart = "hi_c_";
+            return std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
 #endif
+        }
 
-                return sectionEntry->GetCommentKeyNames(commentKeyStart);
-            }
-
-            return {};
+        void Publish(havINISnapshot snapshot)
+        {
+            Publish(std::make_shared<const havINISnapshot>(std::move(snapshot)));
         }
 
-        bool RemoveComment(std::string sectionName, std::string keyName)
+        void Publish(havINISnapshotHandle snapshot)
         {
-            if (sectionName.empty() == true)
+            if (snapshot == nullptr)
             {
-                sectionName = "HI_Global";
+                throw std::invalid_argument("Snapshot must not be null!");
             }
 
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            keyName = havUtils::ToLower(keyName, mLocale);
+#ifdef __cpp_lib_atomic_shared_ptr
+            mSnapshot.store(std::move(snapshot), std::memory_order_release);
+#else
+            std::atomic_store_explicit(&mSnapshot, std::move(snapshot), std::memory_order_release);
 #endif
+        }
+
+        // Publishes a snapshot of a stream, e.g. one with custom settings
+        template<class Allocator>
+        void Publish(basic_havINIStream<CasePolicy, Allocator>& stream)
+        {
+            Publish(stream.Freeze());
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        // Parses the file into a new stream and publishes it, the current snapshot stays active if ParseFile fails
+        bool ReloadFile(const std::string& fileName)
+        {
+            basic_havINIStream<CasePolicy> stream;
 
-            if (sectionEntry != mData.end())
+            if (stream.ParseFile(fileName) == false)
             {
-                return sectionEntry->RemoveComment(keyName);
+                return false;
             }
 
-            return false;
+            Publish(stream);
+
+            return true;
         }
 
-        bool SetInlineComment(std::string sectionName, std::string keyName, const std::string& inlineComment)
+        bool ReloadString(std::string_view contents)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
-
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            basic_havINIStream<CasePolicy> stream;
 
-            if (sectionEntry != mData.end())
+            if (stream.ParseString(contents) == false)
             {
-                const std::vector<havINIData>& keyValuePairs = sectionEntry->GetKeyValuePairs();
-
-                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
-
-                if (keyValuePair != keyValuePairs.end())
-                {
-                    keyValuePair->SetInlineComment(inlineComment);
-
-                    return true;
-                }
+                return false;
             }
 
-            return false;
+            Publish(stream);
+
+            return true;
         }
 
-        bool RemoveKey(std::string sectionName, std::string keyName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            keyName = havUtils::ToLower(keyName, mLocale);
+    private:
+#ifdef __cpp_lib_atomic_shared_ptr
+        std::atomic<havINISnapshotHandle> mSnapshot;
+#else
+        havINISnapshotHandle mSnapshot; // Only accessed with the atomic shared_ptr functions
 #endif
+    };
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
-
-            if (sectionEntry != mData.end())
-            {
-                const std::vector<havINIData>& keyValuePairs = sectionEntry->GetKeyValuePairs();
-
-                auto keyValuePair = sectionEntry->GetKeyValuePair(keyName);
+    // Ordered layers of a configuration, e.g. base, region, host and tenant. A key of a later layer overrides the key in the earlier layers,
+    // arrays are overridden as a whole. The layers are resolved into one snapshot whenever a layer is set, so a lookup costs the same
+    // no matter how many layers there are. Like a snapshot, an overlay can be read by any number of threads, as long as no layer is set.
+    template<class CasePolicy>
+    class basic_havINIOverlay
+    {
+    public:
+        using havINISnapshot = basic_havINISnapshot<CasePolicy>;
 
-                if (keyValuePair != keyValuePairs.end())
-                {
-                    sectionEntry->RemoveKeyValuePair(keyValuePair);
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-                    return true;
-                }
-            }
+        basic_havINIOverlay() = default;
 
-            return false;
+        // The first layer has the lowest priority
+        explicit basic_havINIOverlay(std::vector<havINISnapshot> layers) : mLayers(std::move(layers))
+        {
+            Resolve();
         }
 
-        bool RemoveSection(std::string sectionName)
+        // Adds a layer on top of the others
+        void AddLayer(havINISnapshot snapshot)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            mLayers.push_back(std::move(snapshot));
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            Resolve();
+        }
 
-            if (sectionEntry != mData.end())
-            {
-                mData.erase(sectionEntry);
+        template<class Allocator>
+        void AddLayer(basic_havINIStream<CasePolicy, Allocator>& stream)
+        {
+            AddLayer(stream.Freeze());
+        }
 
-                return true;
-            }
+        // Replaces a layer, e.g. after its file was reloaded
+        void SetLayer(std::size_t layer, havINISnapshot snapshot)
+        {
+            mLayers.at(layer) = std::move(snapshot);
 
-            return false;
+            Resolve();
         }
 
-        bool RenameKey(std::string sectionName, std::string oldKeyName, std::string newKeyName)
+        template<class Allocator>
+        void SetLayer(std::size_t layer, basic_havINIStream<CasePolicy, Allocator>& stream)
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            oldKeyName = havUtils::ToLower(oldKeyName, mLocale);
-            newKeyName = havUtils::ToLower(newKeyName, mLocale);
-#endif
+            SetLayer(layer, stream.Freeze());
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        std::size_t GetNumberOfLayers() const { return mLayers.size(); }
+        const havINISnapshot& GetLayer(std::size_t layer) const { return mLayers.at(layer); }
 
-            if (sectionEntry != mData.end())
-            {
-                const std::vector<havINIData>& keyValuePairs = sectionEntry->GetKeyValuePairs();
+        // The resolved configuration, e.g. to publish it with basic_havINISharedConfig
+        const havINISnapshot& GetSnapshot() const { return mResolved; }
 
-                if (std::find_if(keyValuePairs.begin(), keyValuePairs.end(), [&](const havINIData& data) { return data.GetKey() == newKeyName; } ) == keyValuePairs.end())
-                {
-                    auto keyValuePair = sectionEntry->GetKeyValuePair(oldKeyName);
+        // Returns the layer which supplies the value or array of the key, npos if no layer contains the key
+        std::size_t GetSourceLayer(std::string_view sectionName, std::string_view keyName) const
+        {
+            auto entry = mResolved.FindEntry(sectionName, keyName);
 
-                    if (keyValuePair != keyValuePairs.end())
-                    {
-                        sectionEntry->SetKey(newKeyName, keyValuePair);
+            return (entry == nullptr) ? npos : mEntryLayers[static_cast<std::size_t>(entry - mResolved.mEntries.data())];
+        }
 
-                        return true;
-                    }
-                }
-            }
+        bool HasSection(std::string_view sectionName) const { return mResolved.HasSection(sectionName); }
+        bool HasKey(std::string_view sectionName, std::string_view keyName) const { return mResolved.HasKey(sectionName, keyName); }
+        std::size_t GetNumberOfSections() const { return mResolved.GetNumberOfSections(); }
+        std::size_t GetNumberOfKeys(std::string_view sectionName) const { return mResolved.GetNumberOfKeys(sectionName); }
+        std::vector<std::string_view> GetSectionNames() const { return mResolved.GetSectionNames(); }
+        std::vector<std::string_view> GetKeyNames(std::string_view sectionName) const { return mResolved.GetKeyNames(sectionName); }
 
-            return false;
+        // The view stays valid as long as the overlay exists and no layer is set
+        std::string_view GetValue(std::string_view sectionName, std::string_view keyName, std::string_view defaultValue = {}) const
+        {
+            return mResolved.GetValue(sectionName, keyName, defaultValue);
         }
 
-        bool RenameSection(std::string oldSectionName, std::string newSectionName)
+        template<class KeyRange, class ValueRange>
+        std::size_t GetValues(std::string_view sectionName, const KeyRange& keyNames, ValueRange&& values, std::string_view defaultValue = {}) const
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            oldSectionName = havUtils::ToLower(oldSectionName, mLocale);
-            newSectionName = havUtils::ToLower(newSectionName, mLocale);
-#endif
+            return mResolved.GetValues(sectionName, keyNames, std::forward<ValueRange>(values), defaultValue);
+        }
 
-            if (std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == newSectionName; } ) == mData.end())
-            {
-                auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == oldSectionName; } );
+        template<typename T>
+        T GetValueAs(std::string_view sectionName, std::string_view keyName, T defaultValue) const
+        {
+            return mResolved.GetValueAs(sectionName, keyName, defaultValue);
+        }
 
-                if (sectionEntry != mData.end())
-                {
-                    sectionEntry->SetSectionName(newSectionName);
+        std::size_t GetArraySize(std::string_view sectionName, std::string_view keyName) const { return mResolved.GetArraySize(sectionName, keyName); }
 
-                    return true;
-                }
-            }
+        std::string_view GetArrayValue(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey, std::string_view defaultValue = {}) const
+        {
+            return mResolved.GetArrayValue(sectionName, keyName, arrayKey, defaultValue);
+        }
 
-            return false;
+        template<typename T>
+        T GetArrayValueAs(std::string_view sectionName, std::string_view keyName, std::string_view arrayKey, T defaultValue) const
+        {
+            return mResolved.GetArrayValueAs(sectionName, keyName, arrayKey, defaultValue);
         }
 
-        bool SetSectionInlineComment(std::string sectionName, const std::string& inlineComment)
+        std::vector<std::string_view> GetArrayValues(std::string_view sectionName, std::string_view keyName) const
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            return mResolved.GetArrayValues(sectionName, keyName);
+        }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+        template<typename T>
+        std::vector<T> GetArrayValuesAs(std::string_view sectionName, std::string_view keyName, T defaultValue) const
+        {
+            return mResolved.GetArrayValuesAs(sectionName, keyName, defaultValue);
+        }
 
-            if (sectionEntry != mData.end())
-            {
-                sectionEntry->SetInlineComment(inlineComment);
+    private:
+        void Resolve()
+        {
+            mResolved = havINISnapshot::Merge(mLayers, mEntryLayers);
+        }
 
-                return true;
-            }
+        std::vector<havINISnapshot> mLayers;
+        havINISnapshot mResolved;
+        std::vector<std::uint32_t> mEntryLayers; // Entry of mResolved -> layer
+    };
 
-            return false;
-        }
+    // Binds a key to a member of a struct, created with HAVINI_BIND or havINIMakeBinding
+    template<class Struct, class Field, class Default>
+    struct havINIBinding
+    {
+        std::string_view sectionName; // Empty for the global section
+        std::string_view keyName;
+        Field Struct::* member;
+        Default defaultValue;
+        std::uint64_t hash; // havUtils::HashName of "sectionName]keyName", ']' can't be part of a section name
+
+        static_assert(std::is_same_v<Field, std::string> == true || (std::is_arithmetic_v<Field> == true && std::is_same_v<Field, long double> == false),
+            "Only bool, integer, float, double and std::string fields can be bound!");
+    };
 
-        std::vector<havINIData>::size_type GetNumberOfKeys(std::string sectionName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+    template<class Struct, class Field, class Default>
+    constexpr havINIBinding<Struct, Field, Default> havINIMakeBinding(std::string_view sectionName, std::string_view keyName, Field Struct::* member, Default defaultValue)
+    {
+        std::uint64_t sectionHash = havUtils::HashName((sectionName.empty() == true) ? std::string_view("HI_Global") : sectionName);
+
+        return havINIBinding<Struct, Field, Default>{ sectionName, keyName, member, defaultValue, havUtils::HashName(keyName, havUtils::HashName("]", sectionHash)) };
+    }
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+    // Maps sections and keys to the members of a struct, a document or the events of ParseFileEvents are read in a single pass.
+    // The keys are matched by the hashes of their names, which are computed when the schema is created, e.g. at compile time:
+    //
+    //     constexpr auto serverSchema = havINI::havINIMakeSchema<ServerConfig>(HAVINI_BIND(ServerConfig, "Server", port, 8080), HAVINI_BIND(ServerConfig, "Server", host, "localhost"));
+    //
+    // Every field is set to its default value first. Missing keys and values which can't be converted are returned together in errors, in the order of the bindings.
+    template<class Struct, class... Bindings>
+    class havINISchema
+    {
+        static_assert(sizeof...(Bindings) > 0, "A schema needs at least one binding!");
 
-            if (sectionEntry == mData.end())
+    public:
+        constexpr explicit havINISchema(Bindings... bindings) : mBindings(bindings...), mOrder()
+        {
+            std::uint64_t hashes[sizeof...(Bindings)] = { bindings.hash... };
+
+            // Insertion sort of the slots by hash, so a key is found with a binary search
+            for (std::size_t slot = 0; slot < sizeof...(Bindings); ++slot)
             {
-                return 0;
-            }
+                std::size_t index = slot;
 
-            return sectionEntry->GetNumberOfKeys();
-        }
+                for (; index > 0 && hashes[mOrder[index - 1]] > hashes[slot]; --index)
+                {
+                    mOrder[index] = mOrder[index - 1];
+                }
 
-        std::vector<havINISection>::size_type GetNumberOfSections()
-        {
-            return mData.size();
+                mOrder[index] = slot;
+                mHashes[slot] = hashes[slot];
+            }
         }
 
-        bool HasKey(std::string sectionName, std::string keyName)
+        // Reads the fields of every section, returns true if no error was found
+        template<class CasePolicy, class Allocator>
+        bool Read(basic_havINIStream<CasePolicy, Allocator>& stream, Struct& value, havINIBindErrors& errors) const
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-            keyName = havUtils::ToLower(keyName, mLocale);
-#endif
+            errors.clear();
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            havINIFieldStates states{};
 
-            if (sectionEntry != mData.end())
+            SetDefaultValues<CasePolicy>(value, std::string_view(), false);
+
+            for (std::size_t sectionIndex = 0; sectionIndex < stream.GetNumberOfSections(); ++sectionIndex)
             {
-                return sectionEntry->HasKey(keyName);
+                ReadKeys(stream[static_cast<int>(sectionIndex)], value, states);
             }
 
-            return false;
+            AddErrors<CasePolicy>(states, std::string_view(), false, errors);
+
+            return errors.empty();
         }
 
-        bool HasSection(std::string sectionName)
+        // Only reads the fields which are bound to this section
+        template<class CasePolicy, class Allocator>
+        bool ReadSection(const basic_havINISection<CasePolicy, Allocator>& section, Struct& value, havINIBindErrors& errors) const
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            errors.clear();
+
+            havINIFieldStates states{};
+
+            SetDefaultValues<CasePolicy>(value, section.GetSectionName(), true);
+            ReadKeys(section, value, states);
+            AddErrors<CasePolicy>(states, section.GetSectionName(), true, errors);
 
-            return std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } ) != mData.end();
+            return errors.empty();
         }
 
-        bool ClearSection(std::string sectionName)
+        // Parses the file with ParseFileEvents of the stream (Only its settings are used), no document is built
+        template<class CasePolicy, class Allocator>
+        havINIParseResult ReadFile(basic_havINIStream<CasePolicy, Allocator>& stream, const std::string& fileName, Struct& value, havINIBindErrors& errors) const
         {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            errors.clear();
 
-            auto sectionEntry = std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+            havINIReader<CasePolicy> reader{ *this, value };
 
-            if (sectionEntry != mData.end())
-            {
-                sectionEntry->Clear();
+            SetDefaultValues<CasePolicy>(value, std::string_view(), false);
 
-                return true;
-            }
+            havINIParseResult result = stream.ParseFileEvents(fileName, reader);
 
-            return false;
+            AddErrors<CasePolicy>(reader.states, std::string_view(), false, errors);
+
+            return result;
         }
 
-        void SetNewline(const std::string& newline)
+    private:
+        // The errors are added at the end, so a key which appears more than once (Or an array with several entries) is reported once and the last value counts
+        enum class havINIFieldState : std::uint8_t
         {
-            if (newline != "\n" && newline != "\r" && newline != "\r\n")
-            {
-                throw std::runtime_error("Only \"\", \"\" or \"\" are allowed as new line!");
-            }
+            Missing,
+            Found,
+            Invalid
+        };
 
-            mNewline = newline;
-        }
+        using havINIFieldStates = std::array<havINIFieldState, sizeof...(Bindings)>;
 
-        void SetCommentCharacter(char commentCharacter)
+        // Fills the fields while the events of a file are parsed
+        template<class CasePolicy>
+        struct havINIReader
         {
-            if (commentCharacter != ';' && commentCharacter != '#')
+            const havINISchema& schema;
+            Struct& value;
+            havINIFieldStates states{};
+            std::uint64_t sectionHash = havUtils::HashName("]", havUtils::HashName("HI_Global"));
+
+            bool OnSection(std::string_view sectionName, std::optional<std::string_view>)
             {
-                throw std::runtime_error("Only \";\" or \"#\" are allowed as comment character!");
-            }
+                sectionHash = havUtils::HashName("]", havUtils::HashName(sectionName));
 
-            mCommentCharacter = commentCharacter;
-        }
+                return true;
+            }
 
-        void SetValueQuoteCharacter(char valueQuoteCharacter)
-        {
-            if (valueQuoteCharacter != '\"' && valueQuoteCharacter != '\'')
+            bool OnKey(std::string_view sectionName, std::string_view keyName, std::string_view keyValue, bool, std::optional<std::string_view>)
             {
-                throw std::runtime_error("Only \"\"\" or \"\'\" are allowed as quote character!");
-            }
+                schema.template SetField<CasePolicy>(sectionHash, sectionName, keyName, &keyValue, value, states);
 
-            mValueQuoteCharacter = valueQuoteCharacter;
-        }
+                return true;
+            }
 
-        void SetKeyValuePairDelimiter(char keyValuePairDelimiter)
-        {
-            if (keyValuePairDelimiter != '=' && keyValuePairDelimiter != ':')
+            bool OnArrayEntry(std::string_view sectionName, std::string_view keyName, std::optional<std::string_view>, std::string_view, bool, std::optional<std::string_view>)
             {
-                throw std::runtime_error("Only \"=\" or \":\" are allowed as key value pair delimiter!");
+                schema.template SetField<CasePolicy>(sectionHash, sectionName, keyName, nullptr, value, states);
+
+                return true;
             }
 
-            mKeyValuePairDelimiter = keyValuePairDelimiter;
-        }
+            bool OnComment(std::string_view, std::string_view) { return true; }
+            bool OnEmptyLine(std::string_view) { return true; }
+        };
 
-        void SetLocale(const std::locale& value)
+        template<class CasePolicy>
+        static bool IsSectionName(std::string_view sectionName, std::string_view bindingSectionName)
         {
-            mLocale = value;
+            return CasePolicy::Equal(sectionName, (bindingSectionName.empty() == true) ? std::string_view("HI_Global") : bindingSectionName);
         }
 
-        const std::string& GetNewline() const { return mNewline; }
-        char GetCommentCharacter() const { return mCommentCharacter; }
-        char GetValueQuoteCharacter() const { return mValueQuoteCharacter; }
-        char GetKeyValuePairDelimiter() const { return mKeyValuePairDelimiter; }
-        std::locale GetLocale() const { return mLocale; }
-
-#ifdef _WIN32
-        std::wstring ConvertStringToWString(const std::string& value)
+        template<class CasePolicy, class Allocator>
+        void ReadKeys(const basic_havINISection<CasePolicy, Allocator>& section, Struct& value, havINIFieldStates& states) const
         {
-            int numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, nullptr, 0);
-
-            std::wstring wstr(numOfChars, 0);
-
-            numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, &wstr[0], numOfChars);
+            std::uint64_t sectionHash = havUtils::HashName("]", havUtils::HashName(section.GetSectionName()));
 
-            if (numOfChars > 0)
+            for (const auto& keyValuePair : section.GetKeyValuePairs())
             {
-                return wstr;
-            }
+                std::string_view keyValue = keyValuePair.GetValue();
 
-            return std::wstring();
+                SetField<CasePolicy>(sectionHash, section.GetSectionName(), keyValuePair.GetKey(), (keyValuePair.GetType() == havINIDataType::Array) ? nullptr : &keyValue, value, states);
+            }
         }
-#endif
 
-    private:
-        template<class internT, class externT, class stateT>
-        struct havINICodeCvt : std::codecvt<internT, externT, stateT>
+        // Converts the value of every field bound to the key, an array (keyValue is a null pointer) can't be bound
+        template<class CasePolicy>
+        void SetField(std::uint64_t sectionHash, std::string_view sectionName, std::string_view keyName, const std::string_view* keyValue,
+            Struct& value, havINIFieldStates& states) const
         {
-            ~havINICodeCvt() {}
-        };
+            std::uint64_t hash = havUtils::HashName(keyName, sectionHash);
 
-        std::vector<havINISection>::iterator GetSection(std::string sectionName)
-        {
-#ifndef HAVINI_CASE_SENSITIVE
-            sectionName = havUtils::ToLower(sectionName, mLocale);
-#endif
+            const std::size_t* orderEnd = mOrder.data() + mOrder.size();
+            const std::size_t* order = std::lower_bound(mOrder.data(), orderEnd, hash, [this](std::size_t slot, std::uint64_t otherHash) { return mHashes[slot] < otherHash; });
+
+            for (; order != orderEnd && mHashes[*order] == hash; ++order)
+            {
+                VisitBinding(*order, [&](const auto& binding)
+                {
+                    // The hash ignores the case, the names are compared to rule out collisions and keys which only match case-insensitively
+                    if (CasePolicy::Equal(keyName, binding.keyName) == false || IsSectionName<CasePolicy>(sectionName, binding.sectionName) == false)
+                    {
+                        return;
+                    }
 
-            return std::find_if(mData.begin(), mData.end(), [&](const havINISection& section) { return section.GetSectionName() == sectionName; } );
+                    if (keyValue == nullptr || havUtils::ConvertValue(*keyValue, value.*(binding.member)) == false)
+                    {
+                        value.*(binding.member) = binding.defaultValue;
+                        states[*order] = havINIFieldState::Invalid;
+                    }
+                    else
+                    {
+                        states[*order] = havINIFieldState::Found;
+                    }
+                });
+            }
         }
 
-        void WriteStringToFile(const std::string& value, std::FILE* fileStream, havINIBOMType bomType)
+        template<class CasePolicy>
+        void SetDefaultValues(Struct& value, std::string_view sectionName, bool onlySection) const
         {
-            if (bomType == havINIBOMType::None || bomType == havINIBOMType::UTF8)
-            {
-                std::fwrite(value.data(), sizeof(char), value.size(), fileStream);
-            }
-            else if (bomType == havINIBOMType::UTF16LE)
-            {
-                std::u16string u16Conv = std::wstring_convert<havINICodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.from_bytes(value);
-                std::fwrite(u16Conv.data(), sizeof(char16_t), u16Conv.size(), fileStream);
-            }
-            else if (bomType == havINIBOMType::UTF16BE)
+            for (std::size_t slot = 0; slot < sizeof...(Bindings); ++slot)
             {
-                std::u16string u16Conv = std::wstring_convert<havINICodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.from_bytes(value);
-                std::u16string u16ConvBE;
-                for (char16_t currentChar : u16Conv)
+                VisitBinding(slot, [&](const auto& binding)
                 {
-                    u16ConvBE += (((currentChar & 0x00ff) << 8) | ((currentChar & 0xff00) >> 8));
-                }
-                std::fwrite(u16ConvBE.data(), sizeof(char16_t), u16ConvBE.size(), fileStream);
-            }
-            else if (bomType == havINIBOMType::UTF32LE)
-            {
-                std::u32string u32Conv = std::wstring_convert<havINICodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.from_bytes(value);
-                std::fwrite(u32Conv.data(), sizeof(char32_t), u32Conv.size(), fileStream);
+                    if (onlySection == false || IsSectionName<CasePolicy>(sectionName, binding.sectionName) == true)
+                    {
+                        value.*(binding.member) = binding.defaultValue;
+                    }
+                });
             }
-            else if (bomType == havINIBOMType::UTF32BE)
+        }
+
+        template<class CasePolicy>
+        void AddErrors(const havINIFieldStates& states, std::string_view sectionName, bool onlySection, havINIBindErrors& errors) const
+        {
+            for (std::size_t slot = 0; slot < sizeof...(Bindings); ++slot)
             {
-                std::u32string u32Conv = std::wstring_convert<havINICodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.from_bytes(value);
-                std::u32string u32ConvBE;
-                for (char32_t currentChar : u32Conv)
+                VisitBinding(slot, [&](const auto& binding)
                 {
-                    u32ConvBE += (((currentChar & 0x000000ff) << 24) |
-                                  ((currentChar & 0x0000ff00) << 8) |
-                                  ((currentChar & 0x00ff0000) >> 8) |
-                                  ((currentChar & 0xff000000) >> 24));
-                }
-                std::fwrite(u32ConvBE.data(), sizeof(char32_t), u32ConvBE.size(), fileStream);
+                    if (states[slot] != havINIFieldState::Found && (onlySection == false || IsSectionName<CasePolicy>(sectionName, binding.sectionName) == true))
+                    {
+                        havINIBindErrorType type = (states[slot] == havINIFieldState::Missing) ? havINIBindErrorType::Missing : havINIBindErrorType::Invalid;
+
+                        errors.push_back(havINIBindError{ type, std::string(binding.sectionName), std::string(binding.keyName) });
+                    }
+                });
             }
         }
 
-        // Default INI newline, characters and delimiter
-        std::string mNewline = "\r\n";
-        char mCommentCharacter = ';';
-        char mValueQuoteCharacter = '\"';
-        char mKeyValuePairDelimiter = '=';
+        template<class Visitor>
+        void VisitBinding(std::size_t slot, Visitor visitor) const
+        {
+            VisitBinding(slot, visitor, std::index_sequence_for<Bindings...>());
+        }
 
-        std::locale mLocale = std::locale();
+        template<class Visitor, std::size_t... Slots>
+        void VisitBinding(std::size_t slot, Visitor& visitor, std::index_sequence<Slots...>) const
+        {
+            ((slot == Slots ? (visitor(std::get<Slots>(mBindings)), true) : false) || ...);
+        }
 
-        // Notes:
-        // HI_EL_x / hi_el_x - Indicates that we're dealing with an empty line (x = number)
-        // HI_C_x / hi_c_x - Indicates that we're dealing with a comment (x = number)
-        std::vector<havINISection> mData; // A section contains key value pairs
+        std::tuple<Bindings...> mBindings;
+        std::array<std::size_t, sizeof...(Bindings)> mOrder; // Slots sorted by hash
+        std::array<std::uint64_t, sizeof...(Bindings)> mHashes{};
     };
+
+    template<class Struct, class... Bindings>
+    constexpr havINISchema<Struct, Bindings...> havINIMakeSchema(Bindings... bindings)
+    {
+        return havINISchema<Struct, Bindings...>(bindings...);
+    }
+
+// Binds the key fieldName of the section to the member fieldName of StructType, e.g. HAVINI_BIND(ServerConfig, "Server", port, 8080)
+#define HAVINI_BIND(StructType, sectionName, fieldName, defaultValue) havINI::havINIMakeBinding(sectionName, #fieldName, &StructType::fieldName, defaultValue)
+
+    using havINIData = basic_havINIData<havINIDefaultCasePolicy>;
+    using havINISection = basic_havINISection<havINIDefaultCasePolicy>;
+    using havINIStream = basic_havINIStream<havINIDefaultCasePolicy>;
+    using havINISnapshot = basic_havINISnapshot<havINIDefaultCasePolicy>;
+    using havINISharedConfig = basic_havINISharedConfig<havINIDefaultCasePolicy>;
+    using havINIOverlay = basic_havINIOverlay<havINIDefaultCasePolicy>;
+
+#ifdef __cpp_lib_memory_resource
+    namespace pmr
+    {
+        using havINIData = basic_havINIData<havINIDefaultCasePolicy, std::pmr::polymorphic_allocator<char>>;
+        using havINISection = basic_havINISection<havINIDefaultCasePolicy, std::pmr::polymorphic_allocator<char>>;
+        using havINIStream = basic_havINIStream<havINIDefaultCasePolicy, std::pmr::polymorphic_allocator<char>>;
+    }
+#endif
 }
 
 #endif
@@ -0,0 +1,1081 @@
+// Regression tests for behavior which is easy to break silently, every test prints the failed checks and main returns 1 if any check failed.
+
+#include "havINI.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define HAVINI_CHECK(condition) havINITest::Check((condition), #condition, __LINE__)
+
+namespace havINITest {
+
+    int gFailedCheckCount = 0;
+
+    void Check(bool condition, const char* expression, int line)
+    {
+        if (condition == false)
+        {
+            // std::cerr, because tests redirect std::cout to check that nothing is printed
+            std::cerr << "Check failed in line " << line << ": " << expression << "\n";
+            ++gFailedCheckCount;
+        }
+    }
+
+    bool Contains(const std::string& contents, const std::string& value)
+    {
+        return contents.find(value) != std::string::npos;
+    }
+
+    bool HasChange(const havINI::havINIChangeSet& changes, havINI::havINIChangeType type, const std::string& sectionName, const std::string& keyName)
+    {
+        for (const havINI::havINIChange& change : changes)
+        {
+            if (change.type == type && change.sectionName == sectionName && change.keyName == keyName)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // The document after a reload must be the same as after a fresh parse of the new contents
+    bool IsSameAsFreshParse(havINI::havINIStream& stream, const std::string& contents)
+    {
+        havINI::havINIStream freshStream;
+        freshStream.ParseString(contents);
+
+        return stream.WriteString() == freshStream.WriteString();
+    }
+
+    std::filesystem::path GetTestFileName(const std::string& name)
+    {
+        return std::filesystem::temp_directory_path() / ("havINI_test_" + name + ".ini");
+    }
+
+    void WriteTestFile(const std::filesystem::path& fileName, const std::string& contents)
+    {
+        std::ofstream fileStream(fileName, std::ios::binary | std::ios::trunc);
+        fileStream << contents;
+    }
+
+    std::string ReadTestFile(const std::filesystem::path& fileName)
+    {
+        std::ifstream fileStream(fileName, std::ios::binary);
+
+        return std::string(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+    }
+
+    std::uint32_t ReadUInt32(const std::string& image, std::size_t offset)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, image.data() + offset, sizeof(value));
+
+        return value;
+    }
+
+    void WriteUInt32(std::string& image, std::size_t offset, std::uint32_t value)
+    {
+        std::memcpy(&image[offset], &value, sizeof(value));
+    }
+
+    // A document which is written back unchanged, every section has a comment, an empty line, a quoted value, an inline comment, an array and an escape sequence
+    std::string BuildTestDocument(std::size_t sectionCount)
+    {
+        std::string contents = "global=1";
+
+        for (std::size_t section = 0; section < sectionCount; ++section)
+        {
+            std::string number = std::to_string(section);
+
+            contents += "\r\n\r\n; Section " + number + "\r\n[section" + number + "]\r\nkey=value" + number + "\r\nquoted=\"a b\"\r\ninline=1; comment\r\narray[]=x\r\narray[]=y" + number + "\r\nescaped=\\x00e4";
+        }
+
+        return contents;
+    }
+
+    struct havINIParsedDocument
+    {
+        bool isParsed = false;
+        std::string contents; // Written after the parse
+        std::vector<havINI::havINIDiagnostic> diagnostics; // Only errors, a skipped BOM is reported as a notice
+    };
+
+    havINIParsedDocument ParseDocument(const std::function<bool(havINI::havINIStream&)>& parse)
+    {
+        havINIParsedDocument document;
+        havINI::havINIStream stream;
+        stream.SetDiagnosticSink([&document](const havINI::havINIDiagnostic& diagnostic)
+        {
+            if (diagnostic.type == havINI::havINIDiagnosticType::Error)
+            {
+                document.diagnostics.push_back(diagnostic);
+            }
+        });
+
+        document.isParsed = parse(stream);
+        document.contents = stream.WriteString();
+
+        return document;
+    }
+
+    bool IsSameDiagnostics(const std::vector<havINI::havINIDiagnostic>& diagnostics, const std::vector<havINI::havINIDiagnostic>& otherDiagnostics)
+    {
+        return std::equal(diagnostics.begin(), diagnostics.end(), otherDiagnostics.begin(), otherDiagnostics.end(), [](const havINI::havINIDiagnostic& diagnostic, const havINI::havINIDiagnostic& otherDiagnostic)
+        {
+            return diagnostic.code == otherDiagnostic.code && diagnostic.line == otherDiagnostic.line && diagnostic.message == otherDiagnostic.message;
+        });
+    }
+
+    // Renaming a section through its public SetSectionName must not leave the section index of the stream stale
+    void TestRenameSectionThroughReference()
+    {
+        havINI::havINIStream stream;
+
+        for (int index = 0; index < 40; ++index)
+        {
+            stream["section" + std::to_string(index)]["k"] = std::to_string(index);
+        }
+
+        HAVINI_CHECK(stream.HasSection("section20") == true);
+
+        stream["section20"].SetSectionName("renamed");
+
+        HAVINI_CHECK(stream.HasSection("renamed") == true);
+        HAVINI_CHECK(stream.HasSection("section20") == false);
+        HAVINI_CHECK(stream.GetValue("renamed", "k", "") == "20");
+        HAVINI_CHECK(stream.GetValue("section21", "k", "") == "21");
+    }
+
+    // The tokenizer keeps sections without keys, accepts every line ending and keeps the indices of key[index] arrays
+    void TestTokenizer()
+    {
+        {
+            havINI::havINIStream stream;
+            HAVINI_CHECK(stream.ParseString("[a]\n[b]\nk=1\n[c]\n") == true);
+            HAVINI_CHECK(stream.HasSection("a") == true);
+            HAVINI_CHECK(stream.HasSection("c") == true);
+            HAVINI_CHECK(stream.GetValue("b", "k", "") == "1");
+
+            std::string contents = stream.WriteString();
+            HAVINI_CHECK(Contains(contents, "[a]") == true);
+            HAVINI_CHECK(Contains(contents, "[c]") == true);
+        }
+
+        for (const char* source : { "[a]\rk=1\rj = 2 \r[b]\rz=3", "[a]\r\nk=1\r\nj = 2 \r\n\r\n[b]\r\nz=3\r\n", "[a]\nk=1\r\nj = 2 \r[b]\nz=3" })
+        {
+            havINI::havINIStream stream;
+            HAVINI_CHECK(stream.ParseString(source) == true);
+            HAVINI_CHECK(stream.GetValue("a", "k", "") == "1");
+            HAVINI_CHECK(stream.GetValue("a", "j", "") == "2");
+            HAVINI_CHECK(stream.GetValue("b", "z", "") == "3");
+        }
+
+        {
+            havINI::havINIStream stream;
+            HAVINI_CHECK(stream.ParseString("[a]\narray[5]=x\narray[2]=y\narray[]=z\nk=1 ; comment\nescaped=a\\x0041b\n") == true);
+
+            havINI::havINIData& array = stream["a"]["array"];
+            HAVINI_CHECK(array.ArraySize() == 3);
+            HAVINI_CHECK(array.ArrayAt(0).GetValue() == "x");
+            HAVINI_CHECK(array.ArrayAt(2).GetValue() == "z");
+            HAVINI_CHECK(stream.GetValue("a", "k", "") == "1");
+            HAVINI_CHECK(stream.GetValue("a", "escaped", "") == "aAb");
+
+            std::string contents = stream.WriteString();
+            HAVINI_CHECK(Contains(contents, "array[5]=x") == true);
+            HAVINI_CHECK(Contains(contents, "array[2]=y") == true);
+        }
+    }
+
+    // A reference which is held across an incremental write must still mark its key value pair as modified
+    void TestIncrementalWriteHeldReference()
+    {
+        havINI::havINIStream stream;
+        stream.SetIncrementalWrite(true);
+        stream.ParseString("[a]\nk=1\narray[]=x\n\n[b]\nother=2\n");
+
+        havINI::havINIData& keyValuePair = stream["a"]["k"];
+        havINI::havINIData& arrayEntry = stream["a"]["array"][0];
+
+        std::string contents = stream.WriteString();
+        HAVINI_CHECK(Contains(contents, "k=1") == true);
+
+        keyValuePair.SetValue("CHANGED");
+        contents = stream.WriteString();
+        HAVINI_CHECK(Contains(contents, "k=CHANGED") == true);
+        HAVINI_CHECK(Contains(contents, "other=2") == true);
+
+        arrayEntry.SetValue("y");
+        contents = stream.WriteString();
+        HAVINI_CHECK(Contains(contents, "array[]=y") == true);
+
+        // Nothing changed since the last write
+        HAVINI_CHECK(stream.WriteString() == contents);
+        HAVINI_CHECK(stream["b"].IsModified() == false);
+    }
+
+    // ParseFile hashes a section which spans several blocks piece by piece, ReloadFile and the parallel parse hash it at once
+    void TestHashOfSplitData()
+    {
+        std::string data;
+
+        for (int index = 0; index < 200; ++index)
+        {
+            data += static_cast<char>(index * 7 + 3);
+        }
+
+        for (std::size_t firstSize = 0; firstSize <= data.size(); firstSize += 13)
+        {
+            havINI::havUtils::havINIHasher hasher;
+            hasher.Append(std::string_view(data).substr(0, firstSize));
+            hasher.Append(std::string_view());
+
+            for (std::size_t index = firstSize; index < data.size(); index += 5)
+            {
+                hasher.Append(std::string_view(data).substr(index, 5));
+            }
+
+            HAVINI_CHECK(hasher.GetHash() == havINI::havUtils::HashBytes(data));
+        }
+    }
+
+    // A write which keeps the size and the modification time (e.g. two writes within the time granularity) must not be missed by ReloadFile
+    void TestReloadWithUnchangedModificationTime()
+    {
+        std::filesystem::path fileName = GetTestFileName("reload");
+        havINI::havINIStream stream;
+        havINI::havINIChangeSet changes;
+
+        WriteTestFile(fileName, "[a]\nk=1\n");
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(fileName);
+
+        HAVINI_CHECK(stream.ParseFile(fileName.string()) == true);
+
+        WriteTestFile(fileName, "[a]\nk=2\n");
+        std::filesystem::last_write_time(fileName, writeTime);
+
+        HAVINI_CHECK(stream.ReloadFile(fileName.string(), changes) == true);
+        HAVINI_CHECK(changes.size() == 1);
+        HAVINI_CHECK(stream.GetValue("a", "k", "") == "2");
+
+        // A different size is noticed even for a modification time which is old enough to be trusted
+        std::filesystem::file_time_type oldWriteTime = writeTime - std::chrono::hours(1);
+        std::filesystem::last_write_time(fileName, oldWriteTime);
+
+        HAVINI_CHECK(stream.ReloadFile(fileName.string(), changes) == true);
+        HAVINI_CHECK(changes.empty() == true);
+
+        WriteTestFile(fileName, "[a]\nk=333\n");
+        std::filesystem::last_write_time(fileName, oldWriteTime);
+
+        HAVINI_CHECK(stream.ReloadFile(fileName.string(), changes) == true);
+        HAVINI_CHECK(stream.GetValue("a", "k", "") == "333");
+
+        std::filesystem::remove(fileName);
+    }
+
+    // A compiled image with a valid checksum but inconsistent tables must be rejected and compiled again, instead of being read out of bounds
+    void TestInconsistentCompiledImage()
+    {
+        std::filesystem::path sourceFileName = GetTestFileName("compiled");
+        std::filesystem::path imageFileName = sourceFileName.string() + ".bin";
+        std::string source = "[a]\narray[]=x\narray[]=y\n";
+
+        for (int index = 0; index < 40; ++index)
+        {
+            source += "key" + std::to_string(index) + "=" + std::to_string(index) + "\n";
+        }
+
+        WriteTestFile(sourceFileName, source);
+
+        havINI::havINIStream stream;
+        HAVINI_CHECK(stream.ParseFile(sourceFileName.string()) == true);
+        HAVINI_CHECK(stream.SaveCompiled(imageFileName.string(), sourceFileName.string()) == true);
+
+        const std::string image = ReadTestFile(imageFileName);
+
+        // Header offsets of the counts and the checksum, the sections and entries follow the 64 bytes of the header
+        const std::uint32_t sectionCount = ReadUInt32(image, 20);
+        const std::size_t sectionsOffset = 64;
+        const std::size_t entriesOffset = sectionsOffset + sectionCount * 24;
+        const std::size_t entryBucketsOffset = entriesOffset + ReadUInt32(image, 24) * 24 + ReadUInt32(image, 28) * 16 + ReadUInt32(image, 32) * 8;
+        const std::uint32_t entryBucketCount = ReadUInt32(image, 36);
+
+        HAVINI_CHECK(entryBucketCount != 0);
+
+        std::vector<std::function<void(std::string&)>> corruptions =
+        {
+            [&](std::string& corrupted) { for (std::uint32_t index = 0; index < sectionCount; ++index) WriteUInt32(corrupted, sectionsOffset + index * 24 + 8, 0x7FFFFFFF); },
+            [&](std::string& corrupted) { for (std::uint32_t index = 0; index < sectionCount; ++index) WriteUInt32(corrupted, sectionsOffset + index * 24 + 4, 0x7FFFFFFF); },
+            [&](std::string& corrupted) { for (std::uint32_t index = 0; index < sectionCount; ++index) if (ReadUInt32(corrupted, sectionsOffset + index * 24 + 20) != 0) WriteUInt32(corrupted, sectionsOffset + index * 24 + 20, 3); },
+            [&](std::string& corrupted) { for (std::uint32_t index = 0; index < sectionCount; ++index) if (ReadUInt32(corrupted, sectionsOffset + index * 24 + 20) != 0) WriteUInt32(corrupted, sectionsOffset + index * 24 + 16, entryBucketCount); },
+            [&](std::string& corrupted) { WriteUInt32(corrupted, entriesOffset, 0x7FFFFFFF); },
+            [&](std::string& corrupted) { WriteUInt32(corrupted, entriesOffset + 20, 2); },
+            [&](std::string& corrupted) { for (std::uint32_t bucket = 0; bucket < entryBucketCount; ++bucket) WriteUInt32(corrupted, entryBucketsOffset + bucket * 8 + 4, 0x7FFFFFFF); },
+            [&](std::string& corrupted) { for (std::uint32_t bucket = 0; bucket < entryBucketCount; ++bucket) if (ReadUInt32(corrupted, entryBucketsOffset + bucket * 8 + 4) == 0) WriteUInt32(corrupted, entryBucketsOffset + bucket * 8 + 4, 2); }
+        };
+
+        for (const std::function<void(std::string&)>& corrupt : corruptions)
+        {
+            std::string corrupted = image;
+            corrupt(corrupted);
+
+            std::uint64_t checksum = havINI::havUtils::HashBytes(std::string_view(corrupted).substr(64));
+            std::memcpy(&corrupted[56], &checksum, sizeof(checksum));
+            WriteTestFile(imageFileName, corrupted);
+
+            havINI::havINIStream loadStream;
+            havINI::havINISnapshot snapshot;
+
+            HAVINI_CHECK(loadStream.LoadCompiled(imageFileName.string(), sourceFileName.string(), snapshot) == true);
+            HAVINI_CHECK(snapshot.GetValue("a", "key39", "") == "39");
+            HAVINI_CHECK(snapshot.GetArrayValues("a", "array").size() == 2);
+
+            // The rejected image is replaced with a freshly compiled one
+            HAVINI_CHECK(ReadTestFile(imageFileName) == image);
+        }
+
+        std::filesystem::remove(imageFileName);
+        std::filesystem::remove(sourceFileName);
+    }
+
+    // ReloadString reports the changes of every key and only takes over sections which are unchanged in the source and in memory
+    void TestReloadChangeSets()
+    {
+        const std::string contents = "[a]\nk=1\nold=1\n\n[b]\nx=1\n\n[c]\nq=1\n";
+        havINI::havINIChangeSet changes;
+
+        {
+            havINI::havINIStream stream;
+            stream.ParseString(contents);
+
+            const std::string newContents = "[a]\nk=2\nnew=1\n\n[b]\nx=1\n\n[c]\nq=1\n\n[d]\ny=1\n";
+
+            HAVINI_CHECK(stream.ReloadString(newContents, changes) == true);
+            HAVINI_CHECK(changes.size() == 5);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Changed, "a", "k") == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Removed, "a", "old") == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Added, "a", "new") == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Added, "d", "") == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Added, "d", "y") == true);
+            HAVINI_CHECK(IsSameAsFreshParse(stream, newContents) == true);
+
+            HAVINI_CHECK(stream.ReloadString(contents, changes) == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Removed, "d", "") == true);
+            HAVINI_CHECK(IsSameAsFreshParse(stream, contents) == true);
+        }
+
+        // A key which was added in memory is dropped like by a full parse, even though the source of its section didn't change
+        {
+            havINI::havINIStream stream;
+            stream.ParseString(contents);
+            stream.SetValue("c", "api", "1", false);
+
+            HAVINI_CHECK(stream.ReloadString(contents, changes) == true);
+            HAVINI_CHECK(stream.HasKey("c", "api") == false);
+            HAVINI_CHECK(changes.size() == 1);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Removed, "c", "api") == true);
+            HAVINI_CHECK(IsSameAsFreshParse(stream, contents) == true);
+        }
+
+        // Edits through a held reference and edits which were already written incrementally are reverted too
+        {
+            havINI::havINIStream stream;
+            stream.SetIncrementalWrite(true);
+            stream.ParseString(contents);
+
+            havINI::havINIData& keyValuePair = stream["b"]["x"];
+            keyValuePair.SetValue("2");
+            stream.SetValue("c", "q", "2", false);
+            stream.WriteString();
+
+            HAVINI_CHECK(stream.ReloadString(contents, changes) == true);
+            HAVINI_CHECK(changes.size() == 2);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Changed, "b", "x") == true);
+            HAVINI_CHECK(HasChange(changes, havINI::havINIChangeType::Changed, "c", "q") == true);
+            HAVINI_CHECK(IsSameAsFreshParse(stream, contents) == true);
+
+            // Nothing changed since the reload
+            HAVINI_CHECK(stream.ReloadString(contents, changes) == true);
+            HAVINI_CHECK(changes.empty() == true);
+        }
+    }
+
+    // An invalid escape sequence in a lazily parsed section is reported on the first access of the section instead of being thrown from the lookup
+    void TestLazyParseErrorInSection()
+    {
+        havINI::havINIStream stream;
+        std::vector<havINI::havINIDiagnostic> diagnostics;
+
+        stream.SetLazyParsing(true);
+        stream.SetDiagnosticSink([&diagnostics](const havINI::havINIDiagnostic& diagnostic) { diagnostics.push_back(diagnostic); });
+
+        HAVINI_CHECK(stream.ParseString("[a]\nk=1\n\n[b]\nv=a\\qb\nw=2\n\n[c]\nz=3\n") == true);
+        HAVINI_CHECK(diagnostics.empty() == true);
+
+        bool isThrown = false;
+
+        try
+        {
+            HAVINI_CHECK(stream.GetValue("b", "w", "none") == "none");
+            HAVINI_CHECK(stream.HasKey("b", "v") == false);
+        }
+        catch (const std::exception&)
+        {
+            isThrown = true;
+        }
+
+        HAVINI_CHECK(isThrown == false);
+        HAVINI_CHECK(diagnostics.size() == 1 && diagnostics.front().code == havINI::havINIDiagnosticCode::ParseError);
+        HAVINI_CHECK(stream.GetValue("a", "k", "") == "1");
+        HAVINI_CHECK(stream.GetValue("c", "z", "") == "3");
+        HAVINI_CHECK(diagnostics.size() == 1);
+    }
+
+    // Every parse mode gives the same document and the same diagnostics as ParseString without any option. The document is written back unchanged.
+    void TestParseModesAreEquivalent()
+    {
+        struct havINIParseMode
+        {
+            bool stopsAtError; // Lazy parsing only stops the parsing of the section with the error
+            std::function<bool(havINI::havINIStream&, const std::string&)> parse;
+        };
+
+        std::filesystem::path fileName = GetTestFileName("parse_modes");
+        std::filesystem::path utf8FileName = GetTestFileName("parse_modes_utf8");
+        std::filesystem::path utf16FileName = GetTestFileName("parse_modes_utf16");
+        std::size_t largestTaskCount = 0;
+
+        // The executor runs the tasks one after the other in reverse order, so the result mustn't depend on the order of the tasks
+        havINI::havINIParseExecutor reverseExecutor = [&largestTaskCount](std::size_t taskCount, const std::function<void(std::size_t)>& task)
+        {
+            largestTaskCount = std::max(largestTaskCount, taskCount);
+
+            for (std::size_t index = taskCount; index > 0; --index)
+            {
+                task(index - 1);
+            }
+        };
+
+        const std::vector<havINIParseMode> parseModes =
+        {
+            { false, [](havINI::havINIStream& stream, const std::string& contents) { stream.SetLazyParsing(true); return stream.ParseString(contents); } },
+            { false, [&fileName](havINI::havINIStream& stream, const std::string&) { stream.SetLazyParsing(true); return stream.ParseFile(fileName.string()); } },
+            { true, [](havINI::havINIStream& stream, const std::string& contents) { stream.SetParseThreadCount(4); return stream.ParseString(contents); } },
+            { true, [&fileName](havINI::havINIStream& stream, const std::string&) { stream.SetParseThreadCount(4); return stream.ParseFile(fileName.string()); } },
+            { true, [&](havINI::havINIStream& stream, const std::string& contents) { stream.SetParseThreadCount(4); stream.SetParseExecutor(reverseExecutor); return stream.ParseString(contents); } },
+
+            // Without lazy or parallel parsing a file is parsed in chunks which end within the lines, also after a BOM and in UTF-16
+            { true, [&fileName](havINI::havINIStream& stream, const std::string&) { return stream.ParseFile(fileName.string()); } },
+            { true, [&utf8FileName](havINI::havINIStream& stream, const std::string&) { return stream.ParseFile(utf8FileName.string()); } },
+            { true, [&utf16FileName](havINI::havINIStream& stream, const std::string&) { return stream.ParseFile(utf16FileName.string()); } }
+        };
+
+        std::string document = BuildTestDocument(10000);
+
+        // Sections which appear a second time are merged into their first appearance
+        std::string repeatedDocument = document + "\r\n[section1]\r\nkey=again\r\nadded=1\r\n[section9999]\r\narray[]=z";
+
+        std::string invalidDocument = document;
+        std::size_t errorOffset = invalidDocument.find("\r\nquoted", invalidDocument.find("[section5000]")) + 2;
+        invalidDocument.insert(errorOffset, "garbage\r\n");
+        std::size_t errorLine = static_cast<std::size_t>(std::count(invalidDocument.begin(), invalidDocument.begin() + errorOffset, '\n')) + 1;
+
+        HAVINI_CHECK(ParseDocument([&](havINI::havINIStream& stream) { return stream.ParseString(document); }).contents == document);
+
+        for (const std::string* contents : { &document, &repeatedDocument, &invalidDocument })
+        {
+            bool isInvalid = (contents == &invalidDocument);
+            havINIParsedDocument eagerDocument = ParseDocument([&](havINI::havINIStream& stream) { return stream.ParseString(*contents); });
+            WriteTestFile(fileName, *contents);
+            WriteTestFile(utf8FileName, "\xEF\xBB\xBF" + *contents);
+
+            // The document is ASCII, so every character is followed by a zero byte in UTF-16LE
+            std::string utf16Contents = "\xFF\xFE";
+
+            for (char character : *contents)
+            {
+                utf16Contents += character;
+                utf16Contents += '\0';
+            }
+
+            WriteTestFile(utf16FileName, utf16Contents);
+
+            for (const havINIParseMode& parseMode : parseModes)
+            {
+                havINIParsedDocument parsedDocument = ParseDocument([&](havINI::havINIStream& stream) { return parseMode.parse(stream, *contents); });
+
+                HAVINI_CHECK(parsedDocument.isParsed == eagerDocument.isParsed);
+                HAVINI_CHECK(IsSameDiagnostics(parsedDocument.diagnostics, eagerDocument.diagnostics) == true);
+
+                if (parseMode.stopsAtError == true || isInvalid == false)
+                {
+                    HAVINI_CHECK(parsedDocument.contents == eagerDocument.contents);
+                }
+                else
+                {
+                    HAVINI_CHECK(parsedDocument.contents.compare(0, eagerDocument.contents.size(), eagerDocument.contents) == 0);
+                    HAVINI_CHECK(Contains(parsedDocument.contents, "[section5001]") == true);
+                }
+            }
+
+            if (isInvalid == true)
+            {
+                HAVINI_CHECK(eagerDocument.diagnostics.size() == 1 && eagerDocument.diagnostics.front().line == errorLine);
+                HAVINI_CHECK(Contains(eagerDocument.contents, "key=value5000") == true);
+                HAVINI_CHECK(Contains(eagerDocument.contents, "[section5001]") == false);
+            }
+        }
+
+        // The document is large enough to be split into four tasks
+        HAVINI_CHECK(largestTaskCount == 4);
+
+        std::filesystem::remove(fileName);
+        std::filesystem::remove(utf8FileName);
+        std::filesystem::remove(utf16FileName);
+    }
+
+    // Comments and empty lines are written back at their place, also when they're added or removed and when the key value pair below them is removed
+    void TestTriviaPlacement()
+    {
+        std::string contents = "; Top comment\r\nglobal=1\r\n\r\n[a]\r\n; Above k\r\nk=1\r\n\r\n; Between\r\nj=2; inline\r\n; End of a\r\n\r\n[b]\r\n\r\nz=3\r\n; Last";
+
+        havINI::havINIStream stream;
+        stream.ParseString(contents);
+        HAVINI_CHECK(stream.WriteString() == contents);
+
+        // Comments and empty lines aren't key value pairs, but they're visited in the order of the document
+        HAVINI_CHECK(stream.GetNumberOfKeys("a") == 2);
+        HAVINI_CHECK(stream.HasKey("a", "HI_C_1") == false);
+        HAVINI_CHECK(stream.GetCommentKeyNames("a").size() == 3);
+        HAVINI_CHECK(stream.GetEmptyLineKeyNames("a").size() == 2);
+
+        std::string entryKeys;
+        stream["a"].ForEachEntry([&entryKeys](const havINI::havINIData& data) { entryKeys += std::string(data.GetKey()) + " "; });
+        HAVINI_CHECK(entryKeys == "hi_c_1 k hi_el_1 hi_c_2 j hi_c_3 hi_el_2 ");
+
+        stream.SetComment("a", "New start", havINI::havINIPosition::Start);
+        stream.SetComment("a", "New end", havINI::havINIPosition::End);
+        stream.SetComment("a", "Above j", havINI::havINIPosition::Above, "j");
+        stream.SetComment("a", "Below k", havINI::havINIPosition::Below, "k");
+        stream.SetEmptyLine("b", havINI::havINIPosition::Above, "z");
+        stream.SetEmptyLine("b", havINI::havINIPosition::Below, "z");
+        stream.SetValue("a", "new", "4", false);
+
+        HAVINI_CHECK(stream.WriteString() == "; Top comment\r\nglobal=1\r\n\r\n[a]\r\n; New start\r\n; Above k\r\nk=1\r\n; Below k\r\n\r\n; Between\r\n; Above j\r\nj=2; inline\r\n; End of a\r\n\r\n; New end\r\nnew=4\r\n[b]\r\n\r\n\r\nz=3\r\n\r\n; Last");
+
+        // The comments above a removed key value pair stay in front of the next one
+        stream.RemoveKey("a", "k");
+        HAVINI_CHECK(stream.RemoveComment("a", stream.GetCommentKeyNames("a").front()) == true);
+        HAVINI_CHECK(stream.RemoveEmptyLine("b", stream.GetEmptyLineKeyNames("b").front()) == true);
+
+        HAVINI_CHECK(stream.WriteString() == "; Top comment\r\nglobal=1\r\n\r\n[a]\r\n; Above k\r\n; Below k\r\n\r\n; Between\r\n; Above j\r\nj=2; inline\r\n; End of a\r\n\r\n; New end\r\nnew=4\r\n[b]\r\n\r\nz=3\r\n\r\n; Last");
+
+        havINI::havINIStream withoutComments;
+        withoutComments.SetKeepComments(false);
+        withoutComments.ParseString(contents);
+        HAVINI_CHECK(withoutComments.WriteString() == "global=1\r\n\r\n[a]\r\nk=1\r\n\r\nj=2; inline\r\n\r\n[b]\r\n\r\nz=3");
+
+        havINI::havINIStream withoutEmptyLines;
+        withoutEmptyLines.SetKeepEmptyLines(false);
+        withoutEmptyLines.ParseString(contents);
+        HAVINI_CHECK(withoutEmptyLines.WriteString() == "; Top comment\r\nglobal=1\r\n[a]\r\n; Above k\r\nk=1\r\n; Between\r\nj=2; inline\r\n; End of a\r\n[b]\r\nz=3\r\n; Last");
+    }
+
+    // The event parsers pass every line to the handler without building a document, a handler which returns false stops the parsing
+    void TestParseEvents()
+    {
+        struct havINIRecordingHandler : havINI::havINIEventHandler
+        {
+            std::string events;
+            std::size_t keyCount = 0;
+            std::size_t arrayEntryCount = 0;
+            std::size_t sectionCount = 0;
+            std::size_t triviaCount = 0;
+
+            static std::string Optional(std::optional<std::string_view> value) { return (value.has_value() == true) ? "," + std::string(value.value()) : ""; }
+
+            bool OnSection(std::string_view sectionName, std::optional<std::string_view> inlineComment) override
+            {
+                ++sectionCount;
+                events += "S(" + std::string(sectionName) + Optional(inlineComment) + ") ";
+
+                return true;
+            }
+
+            bool OnKey(std::string_view sectionName, std::string_view keyName, std::string_view value, bool isQuoted, std::optional<std::string_view> inlineComment) override
+            {
+                ++keyCount;
+                events += "K(" + std::string(sectionName) + "," + std::string(keyName) + "," + std::string(value) + (isQuoted == true ? ",quoted" : "") + Optional(inlineComment) + ") ";
+
+                return keyName != "stop";
+            }
+
+            bool OnArrayEntry(std::string_view sectionName, std::string_view keyName, std::optional<std::string_view> arrayIndex, std::string_view value, bool, std::optional<std::string_view>) override
+            {
+                ++arrayEntryCount;
+                events += "A(" + std::string(sectionName) + "," + std::string(keyName) + Optional(arrayIndex) + "," + std::string(value) + ") ";
+
+                return true;
+            }
+
+            bool OnComment(std::string_view sectionName, std::string_view comment) override
+            {
+                ++triviaCount;
+                events += "C(" + std::string(sectionName) + "," + std::string(comment) + ") ";
+
+                return true;
+            }
+
+            bool OnEmptyLine(std::string_view sectionName) override
+            {
+                ++triviaCount;
+                events += "E(" + std::string(sectionName) + ") ";
+
+                return true;
+            }
+        };
+
+        havINI::havINIStream stream;
+        std::vector<havINI::havINIDiagnostic> diagnostics;
+        stream.SetDiagnosticSink([&diagnostics](const havINI::havINIDiagnostic& diagnostic) { diagnostics.push_back(diagnostic); });
+
+        {
+            havINIRecordingHandler handler;
+            HAVINI_CHECK(stream.ParseStringEvents("; top\nGlobal=1\n\n[Sec] ; header\nKey = \"a b\" ; inline\narray[]=x\narray[3]=y\nv=\\x0041\nstop=1\nafter=2\n", handler) == havINI::havINIParseResult::Stopped);
+            HAVINI_CHECK(handler.events == "C(hi_global,top) K(hi_global,global,1) E(hi_global) S(sec,header) K(sec,key,a b,quoted,inline) A(sec,array,x) A(sec,array,3,y) K(sec,v,A) K(sec,stop,1) ");
+            HAVINI_CHECK(diagnostics.empty() == true);
+        }
+
+        {
+            havINIRecordingHandler handler;
+            HAVINI_CHECK(stream.ParseStringEvents("[a]\nk=1\ninvalid\nz=2\n", handler) == havINI::havINIParseResult::Failed);
+            HAVINI_CHECK(handler.events == "S(a) K(a,k,1) ");
+            HAVINI_CHECK(diagnostics.size() == 1 && diagnostics.front().code == havINI::havINIDiagnosticCode::ParseError && diagnostics.front().line == 3);
+        }
+
+        // A file which is read in many chunks gives every event once
+        std::filesystem::path fileName = GetTestFileName("parse_events");
+        WriteTestFile(fileName, BuildTestDocument(10000));
+
+        havINIRecordingHandler handler;
+        HAVINI_CHECK(stream.ParseFileEvents(fileName.string(), handler) == havINI::havINIParseResult::Completed);
+        HAVINI_CHECK(handler.sectionCount == 10000);
+        HAVINI_CHECK(handler.keyCount == 1 + 4 * 10000);
+        HAVINI_CHECK(handler.arrayEntryCount == 2 * 10000);
+        HAVINI_CHECK(handler.triviaCount == 2 * 10000);
+
+        // No document was built
+        HAVINI_CHECK(stream.HasSection("section0") == false);
+        HAVINI_CHECK(stream.WriteString().empty() == true);
+
+        std::filesystem::remove(fileName);
+    }
+
+    // The stream, its snapshot and havUtils::ConvertValue convert values the same way, a value which doesn't fit into T gives the default value
+    void TestValueConversion()
+    {
+        havINI::havINIStream stream;
+        stream.ParseString("[n]\nsmall=127\nlarge=128\nnegative=-1\nfloat=0.5\nflag=true\ntext=12abc\n");
+
+        havINI::havINISnapshot snapshot = stream.Freeze();
+
+        auto check = [&](const char* keyName, auto defaultValue, auto expectedValue)
+        {
+            auto converted = defaultValue;
+            bool isConverted = havINI::havUtils::ConvertValue(stream.GetValue("n", keyName, ""), converted);
+
+            HAVINI_CHECK(stream.GetValueAs("n", keyName, defaultValue) == expectedValue);
+            HAVINI_CHECK(stream.GetValueAs("n", keyName, defaultValue) == expectedValue); // Cached
+            HAVINI_CHECK(snapshot.GetValueAs("n", keyName, defaultValue) == expectedValue);
+            HAVINI_CHECK(converted == expectedValue);
+            HAVINI_CHECK(isConverted == (expectedValue != defaultValue));
+        };
+
+        check("small", static_cast<std::int8_t>(0), static_cast<std::int8_t>(127));
+        check("large", static_cast<std::int8_t>(0), static_cast<std::int8_t>(0));
+        check("large", 0, 128);
+        check("negative", 7u, 7u);
+        check("negative", 0, -1);
+        check("float", 0.0, 0.5);
+        check("flag", false, true);
+        check("text", 3, 3);
+    }
+
+    // Accessing a missing array element throws std::out_of_range without printing anything
+    void TestArrayAccessOutOfRange()
+    {
+        havINI::havINIStream stream;
+        stream.ParseString("[a]\narray[]=x\narray[]=y\n");
+
+        havINI::havINIData& array = stream["a"]["array"];
+        HAVINI_CHECK(array.ArrayFront().GetValue() == "x");
+        HAVINI_CHECK(array.ArrayBack().GetValue() == "y");
+        HAVINI_CHECK(array.ArrayAt(1).GetValue() == "y");
+
+        std::ostringstream output;
+        std::streambuf* coutBuffer = std::cout.rdbuf(output.rdbuf());
+        int thrownCount = 0;
+
+        try { array.ArrayAt(2); } catch (const std::out_of_range&) { ++thrownCount; }
+
+        array.ArrayClear();
+
+        try { array.ArrayFront(); } catch (const std::out_of_range&) { ++thrownCount; }
+        try { array.ArrayBack(); } catch (const std::out_of_range&) { ++thrownCount; }
+
+        std::cout.rdbuf(coutBuffer);
+
+        HAVINI_CHECK(thrownCount == 3);
+        HAVINI_CHECK(output.str().empty() == true);
+    }
+
+    struct havINISchemaTestConfig
+    {
+        std::string host;
+        int port = 0;
+        std::uint8_t level = 0;
+        double ratio = 0.0;
+        bool debug = false;
+    };
+
+    // Every key which is missing or can't be converted is reported and its field keeps the default value, the document and the events give the same result
+    void TestSchemaErrors()
+    {
+        constexpr auto schema = havINI::havINIMakeSchema<havINISchemaTestConfig>(
+            HAVINI_BIND(havINISchemaTestConfig, "Server", host, "localhost"),
+            HAVINI_BIND(havINISchemaTestConfig, "Server", port, 8080),
+            HAVINI_BIND(havINISchemaTestConfig, "Server", level, 1),
+            HAVINI_BIND(havINISchemaTestConfig, "Limits", ratio, 0.5),
+            HAVINI_BIND(havINISchemaTestConfig, "", debug, false));
+
+        auto describe = [](const havINI::havINIBindErrors& errors)
+        {
+            std::vector<std::string> descriptions;
+
+            for (const havINI::havINIBindError& error : errors)
+            {
+                descriptions.push_back(std::string(error.type == havINI::havINIBindErrorType::Missing ? "Missing " : "Invalid ") + error.sectionName + "." + error.keyName);
+            }
+
+            std::sort(descriptions.begin(), descriptions.end());
+
+            return descriptions;
+        };
+
+        std::filesystem::path fileName = GetTestFileName("schema");
+        havINI::havINIBindErrors errors;
+
+        {
+            std::string contents = "DEBUG=true\n[server]\nHost=example\nport=443\nlevel=3\n[limits]\nratio=0.25\n";
+            havINI::havINIStream stream;
+            havINISchemaTestConfig config;
+
+            stream.ParseString(contents);
+            HAVINI_CHECK(schema.Read(stream, config, errors) == true);
+            HAVINI_CHECK(errors.empty() == true);
+            HAVINI_CHECK(config.host == "example" && config.port == 443 && config.level == 3 && config.ratio == 0.25 && config.debug == true);
+
+            WriteTestFile(fileName, contents);
+            havINISchemaTestConfig eventConfig;
+
+            HAVINI_CHECK(schema.ReadFile(stream, fileName.string(), eventConfig, errors) == havINI::havINIParseResult::Completed);
+            HAVINI_CHECK(errors.empty() == true);
+            HAVINI_CHECK(eventConfig.host == "example" && eventConfig.port == 443 && eventConfig.level == 3 && eventConfig.ratio == 0.25 && eventConfig.debug == true);
+        }
+
+        // The port isn't a number, the level doesn't fit into std::uint8_t, the ratio is an array and debug is missing
+        std::string contents = "[Server]\nport=abc\nlevel=300\n[Limits]\nratio[]=1\nratio[]=2\n";
+        const std::vector<std::string> expectedErrors = { "Invalid Limits.ratio", "Invalid Server.level", "Invalid Server.port", "Missing .debug", "Missing Server.host" };
+
+        havINI::havINIStream stream;
+        stream.ParseString(contents);
+
+        havINISchemaTestConfig config;
+        config.port = 1;
+        config.debug = true;
+
+        HAVINI_CHECK(schema.Read(stream, config, errors) == false);
+        HAVINI_CHECK(describe(errors) == expectedErrors);
+        HAVINI_CHECK(config.host == "localhost" && config.port == 8080 && config.level == 1 && config.ratio == 0.5 && config.debug == false);
+
+        WriteTestFile(fileName, contents);
+        havINISchemaTestConfig eventConfig;
+
+        HAVINI_CHECK(schema.ReadFile(stream, fileName.string(), eventConfig, errors) == havINI::havINIParseResult::Completed);
+        HAVINI_CHECK(describe(errors) == expectedErrors);
+        HAVINI_CHECK(eventConfig.host == "localhost" && eventConfig.port == 8080 && eventConfig.level == 1 && eventConfig.ratio == 0.5 && eventConfig.debug == false);
+
+        // Only the fields of the section are read and reported
+        havINISchemaTestConfig sectionConfig;
+        sectionConfig.ratio = 2.0;
+
+        HAVINI_CHECK(schema.ReadSection(stream["Server"], sectionConfig, errors) == false);
+        HAVINI_CHECK(describe(errors) == std::vector<std::string>({ "Invalid Server.level", "Invalid Server.port", "Missing Server.host" }));
+        HAVINI_CHECK(sectionConfig.ratio == 2.0);
+
+        std::filesystem::remove(fileName);
+    }
+
+    // An overlay resolves every key to the topmost layer which contains it, arrays are replaced as a whole and a replaced layer is resolved again
+    void TestOverlayLayers()
+    {
+        havINI::havINIStream baseStream;
+        havINI::havINIStream regionStream;
+        havINI::havINIStream hostStream;
+
+        baseStream.ParseString("global=0\n[db]\nhost=base\nport=1\narray[]=a\narray[]=b\n[base]\nk=1\n");
+        regionStream.ParseString("[db]\nhost=region\n[region]\nr=2\n");
+        hostStream.ParseString("[DB]\nPORT=3\narray[]=z\n");
+
+        havINI::havINIOverlay overlay({ baseStream.Freeze(), regionStream.Freeze() });
+        overlay.AddLayer(hostStream);
+
+        // Every key of every layer has to come from the topmost layer which contains it
+        auto checkResolution = [&overlay]()
+        {
+            for (std::size_t layer = 0; layer < overlay.GetNumberOfLayers(); ++layer)
+            {
+                const havINI::havINISnapshot& snapshot = overlay.GetLayer(layer);
+
+                for (std::string_view sectionName : snapshot.GetSectionNames())
+                {
+                    for (std::string_view keyName : snapshot.GetKeyNames(sectionName))
+                    {
+                        std::size_t sourceLayer = overlay.GetNumberOfLayers() - 1;
+
+                        while (overlay.GetLayer(sourceLayer).HasKey(sectionName, keyName) == false)
+                        {
+                            --sourceLayer;
+                        }
+
+                        HAVINI_CHECK(overlay.GetSourceLayer(sectionName, keyName) == sourceLayer);
+                        HAVINI_CHECK(overlay.GetValue(sectionName, keyName) == overlay.GetLayer(sourceLayer).GetValue(sectionName, keyName));
+                        HAVINI_CHECK(overlay.GetArrayValues(sectionName, keyName) == overlay.GetLayer(sourceLayer).GetArrayValues(sectionName, keyName));
+                    }
+                }
+            }
+        };
+
+        checkResolution();
+        HAVINI_CHECK(overlay.GetNumberOfSections() == 4);
+        HAVINI_CHECK(overlay.GetValue("db", "host") == "region" && overlay.GetSourceLayer("db", "host") == 1);
+        HAVINI_CHECK(overlay.GetValueAs("db", "port", 0) == 3 && overlay.GetSourceLayer("Db", "Port") == 2);
+        HAVINI_CHECK(overlay.GetArrayValues("db", "array") == std::vector<std::string_view>({ "z" }) && overlay.GetSourceLayer("db", "array") == 2);
+        HAVINI_CHECK(overlay.GetSourceLayer("", "global") == 0);
+        HAVINI_CHECK(overlay.GetSourceLayer("db", "missing") == havINI::havINIOverlay::npos);
+        HAVINI_CHECK(overlay.GetSourceLayer("missing", "host") == havINI::havINIOverlay::npos);
+
+        // The region layer is reloaded without its host key
+        regionStream.RemoveKey("db", "host");
+        overlay.SetLayer(1, regionStream);
+
+        checkResolution();
+        HAVINI_CHECK(overlay.GetValue("db", "host") == "base" && overlay.GetSourceLayer("db", "host") == 0);
+        HAVINI_CHECK(overlay.GetValue("region", "r") == "2" && overlay.GetSourceLayer("region", "r") == 1);
+
+        HAVINI_CHECK(havINI::havINIOverlay().GetSourceLayer("db", "host") == havINI::havINIOverlay::npos);
+    }
+
+    // Errors and notices go to the diagnostic sink with their code and the line of a parse error, nothing is printed while a sink is set
+    void TestDiagnostics()
+    {
+        std::vector<havINI::havINIDiagnostic> diagnostics;
+        auto sink = [&diagnostics](const havINI::havINIDiagnostic& diagnostic) { diagnostics.push_back(diagnostic); };
+
+        auto isReported = [&diagnostics](havINI::havINIDiagnosticType type, havINI::havINIDiagnosticCode code, std::size_t line)
+        {
+            bool isSame = diagnostics.size() == 1 && diagnostics.front().type == type && diagnostics.front().code == code && diagnostics.front().line == line;
+            diagnostics.clear();
+
+            return isSame;
+        };
+
+        std::filesystem::path missingFileName = GetTestFileName("diagnostics_missing");
+        std::filesystem::path emptyFileName = GetTestFileName("diagnostics_empty");
+        std::filesystem::path smallFileName = GetTestFileName("diagnostics_small");
+        std::filesystem::path bomFileName = GetTestFileName("diagnostics_bom");
+
+        std::filesystem::remove(missingFileName);
+        WriteTestFile(emptyFileName, "");
+        WriteTestFile(smallFileName, "a=1");
+        WriteTestFile(bomFileName, "\xEF\xBB\xBF[a]\nk=1\n");
+
+        std::ostringstream output;
+        std::streambuf* coutBuffer = std::cout.rdbuf(output.rdbuf());
+
+        // The files are read in chunks, at once for lazy parsing and at once for parallel parsing
+        for (int parseMode = 0; parseMode < 3; ++parseMode)
+        {
+            havINI::havINIStream stream;
+            stream.SetDiagnosticSink(sink);
+            stream.SetLazyParsing(parseMode == 1);
+            stream.SetParseThreadCount((parseMode == 2) ? 2 : 1);
+
+            HAVINI_CHECK(stream.ParseFile(missingFileName.string()) == false);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::OpenFailed, 0) == true);
+            HAVINI_CHECK(stream.ParseFile(emptyFileName.string()) == false);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::EmptyFile, 0) == true);
+            HAVINI_CHECK(stream.ParseFile(smallFileName.string()) == false);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::FileTooSmall, 0) == true);
+            HAVINI_CHECK(stream.ParseFile(bomFileName.string()) == true);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Notice, havINI::havINIDiagnosticCode::BOMSkipped, 0) == true);
+            HAVINI_CHECK(stream.GetValue("a", "k", "") == "1");
+        }
+
+        {
+            havINI::havINIStream stream;
+            stream.SetDiagnosticSink(sink);
+
+            HAVINI_CHECK(stream.ParseString("[a]\nk=1\n\ninvalid\n[b]\nz=2\n") == true);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::ParseError, 4) == true);
+
+            HAVINI_CHECK(stream.WriteFile((missingFileName / "file.ini").string()) == false);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::WriteFailed, 0) == true);
+        }
+
+        {
+            // A reload reports an error in a changed section with its line once, also if the sections can't be taken over and everything is parsed again
+            havINI::havINIStream stream;
+            havINI::havINIChangeSet changes;
+            stream.SetDiagnosticSink(sink);
+            stream.ParseString("[a]\nk=1\n[b]\nz=1\n[c]\nj=1\n");
+
+            HAVINI_CHECK(stream.ReloadString("[a]\nk=1\n[b]\nz=1\n[c]\nj=2\ninvalid\n", changes) == true);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::ParseError, 7) == true);
+
+            HAVINI_CHECK(stream.ReloadString("[a]\nk=1\n[b]\nz=1\n[a]\ninvalid\n", changes) == true);
+            HAVINI_CHECK(isReported(havINI::havINIDiagnosticType::Error, havINI::havINIDiagnosticCode::ParseError, 6) == true);
+        }
+
+        std::cout.rdbuf(coutBuffer);
+        HAVINI_CHECK(output.str().empty() == true);
+
+        // Without a sink the diagnostics are printed to std::cout again
+        {
+            havINI::havINIStream stream;
+            coutBuffer = std::cout.rdbuf(output.rdbuf());
+
+            stream.ParseFile(missingFileName.string());
+
+            std::cout.rdbuf(coutBuffer);
+            HAVINI_CHECK(Contains(output.str(), "Unable to open INI file") == true);
+        }
+
+        {
+            std::string contents = "; comment\n[a]\nk=1\narray[]=x\narray[]=y\n\n[b]\nz=2";
+            havINI::havINIStream stream;
+            stream.SetCollectParseStats(true);
+            stream.ParseString(contents);
+
+            const havINI::havINIParseStats& stats = stream.GetParseStats();
+            HAVINI_CHECK(stats.bytesRead == contents.size());
+            HAVINI_CHECK(stats.lineCount == 8);
+            HAVINI_CHECK(stats.sectionCount == 2);
+            HAVINI_CHECK(stats.keyCount == 4);
+            HAVINI_CHECK(stats.triviaCount == 2);
+        }
+
+        std::filesystem::remove(emptyFileName);
+        std::filesystem::remove(smallFileName);
+        std::filesystem::remove(bomFileName);
+    }
+
+    // Concurrent atomic writes to the same file must each use their own temporary file, so the file always holds one complete write
+    void TestConcurrentAtomicWrites()
+    {
+        std::filesystem::path fileName = GetTestFileName("atomic");
+        std::vector<std::thread> writers;
+        std::vector<int> failedWriteCounts(4, 0);
+
+        for (std::size_t writerIndex = 0; writerIndex < failedWriteCounts.size(); ++writerIndex)
+        {
+            writers.emplace_back([&fileName, &failedWriteCounts, writerIndex]()
+            {
+                havINI::havINIStream stream;
+                stream.SetAtomicWrite(true);
+                stream["a"]["writer"].SetValue(std::to_string(writerIndex));
+                stream["a"]["data"].SetValue(std::string(10000 + writerIndex * 1000, 'x'));
+
+                for (int index = 0; index < 50; ++index)
+                {
+                    if (stream.WriteFile(fileName.string()) == false)
+                    {
+                        ++failedWriteCounts[writerIndex];
+                    }
+                }
+            });
+        }
+
+        for (std::thread& writer : writers)
+        {
+            writer.join();
+        }
+
+        for (int failedWriteCount : failedWriteCounts)
+        {
+            HAVINI_CHECK(failedWriteCount == 0);
+        }
+
+        havINI::havINIStream stream;
+        HAVINI_CHECK(stream.ParseFile(fileName.string()) == true);
+
+        std::size_t writerIndex = static_cast<std::size_t>(std::stoi(stream.GetValue("a", "writer", "0")));
+        HAVINI_CHECK(stream.GetValue("a", "data", "").size() == 10000 + writerIndex * 1000);
+
+        // No temporary file is left behind
+        std::size_t fileCount = 0;
+
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(fileName.parent_path()))
+        {
+            if (entry.path().filename().string().rfind(fileName.filename().string(), 0) == 0)
+            {
+                ++fileCount;
+            }
+        }
+
+        HAVINI_CHECK(fileCount == 1);
+
+        std::filesystem::remove(fileName);
+    }
+}
+
+int main()
+{
+    havINITest::TestTokenizer();
+    havINITest::TestRenameSectionThroughReference();
+    havINITest::TestIncrementalWriteHeldReference();
+    havINITest::TestHashOfSplitData();
+    havINITest::TestReloadWithUnchangedModificationTime();
+    havINITest::TestReloadChangeSets();
+    havINITest::TestLazyParseErrorInSection();
+    havINITest::TestParseModesAreEquivalent();
+    havINITest::TestTriviaPlacement();
+    havINITest::TestParseEvents();
+    havINITest::TestValueConversion();
+    havINITest::TestSchemaErrors();
+    havINITest::TestOverlayLayers();
+    havINITest::TestDiagnostics();
+    havINITest::TestArrayAccessOutOfRange();
+    havINITest::TestInconsistentCompiledImage();
+    havINITest::TestConcurrentAtomicWrites();
+
+    if (havINITest::gFailedCheckCount > 0)
+    {
+        std::cout << havINITest::gFailedCheckCount << " checks failed!\n";
+
+        return 1;
+    }
+
+    return 0;
+}